@@ -32,9 +32,9 @@ public class GCLoading : ModuleRules
         PrivateDependencyModuleNames.AddRange(
             new string[]
             {
-                "DeveloperSettings",
+                "DeveloperSettings", "EngineSettings",
 
-                "RenderCore", "ApplicationCore", "InputCore",
+                "RenderCore", "RHI", "ApplicationCore", "InputCore",
 
                 "PreLoadScreen",
             }
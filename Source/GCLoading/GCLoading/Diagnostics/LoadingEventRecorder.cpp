@@ -0,0 +1,232 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "LoadingEventRecorder.h"
+
+#include "GCLoadingLogs.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+
+namespace LoadingEventRecorder
+{
+	static constexpr uint32 FileMagic{ 0x4C445256 };	// "LDRV"
+	static constexpr int32 FileVersion{ 1 };
+
+	static constexpr uint8 Flag_FromObserver{ 1 << 0 };
+	static constexpr uint8 Flag_Visible{ 1 << 1 };
+
+	static bool HasReason(ELoadingRecordedEventType Type)
+	{
+		return (Type == ELoadingRecordedEventType::ProcessAdded) || (Type == ELoadingRecordedEventType::ReasonChanged);
+	}
+}
+
+
+FString FLoadingEventRecorder::GetFilePath(const FString& RecordingName)
+{
+	return FPaths::ProjectSavedDir() / TEXT("Loading") / TEXT("Recordings") / (RecordingName + TEXT(".bin"));
+}
+
+void FLoadingEventRecorder::BeginRecording(double CurrentTime)
+{
+	Reset();
+
+	StartTime = CurrentTime;
+	bRecording = true;
+}
+
+void FLoadingEventRecorder::EndRecording()
+{
+	bRecording = false;
+}
+
+void FLoadingEventRecorder::Record(ELoadingRecordedEventType Type, double CurrentTime, FName LoadingTypeName, FName ProcessName, FString Reason, bool bFromObserver, bool bVisible)
+{
+	if (!bRecording)
+	{
+		return;
+	}
+
+	auto& Event{ Events.AddDefaulted_GetRef() };
+	Event.Time = FMath::Max(CurrentTime - StartTime, 0.0);
+	Event.Type = Type;
+	Event.LoadingTypeName = LoadingTypeName;
+	Event.ProcessName = ProcessName;
+	Event.Reason = MoveTemp(Reason);
+	Event.bFromObserver = bFromObserver;
+	Event.bVisible = bVisible;
+}
+
+
+bool FLoadingEventRecorder::Load(const FString& FilePath)
+{
+	Reset();
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FilePath, FILEREAD_Silent))
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Loading event recording not found (%s)"), *FilePath);
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+
+	auto Magic{ 0u };
+	auto Version{ 0 };
+	Reader << Magic;
+	Reader << Version;
+
+	if ((Magic != LoadingEventRecorder::FileMagic) || (Version != LoadingEventRecorder::FileVersion))
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Discarded loading event recording with unknown format (%s)"), *FilePath);
+		return false;
+	}
+
+	TArray<FString> NameTable;
+	Reader << NameTable;
+
+	auto NumEvents{ 0u };
+	Reader.SerializeIntPacked(NumEvents);
+
+	Events.Reserve(FMath::Min(NumEvents, static_cast<uint32>(Bytes.Num())));
+
+	// Times are stored as deltas in microseconds and accumulated in integers so that they do not drift
+
+	auto TimeMicros{ 0ull };
+
+	for (auto Index{ 0u }; (Index < NumEvents) && !Reader.IsError(); ++Index)
+	{
+		auto Type{ static_cast<uint8>(0) };
+		auto Flags{ static_cast<uint8>(0) };
+		auto DeltaMicros{ 0u };
+		auto LoadingTypeIndex{ 0u };
+		auto ProcessIndex{ 0u };
+
+		Reader << Type;
+		Reader << Flags;
+		Reader.SerializeIntPacked(DeltaMicros);
+		Reader.SerializeIntPacked(LoadingTypeIndex);
+		Reader.SerializeIntPacked(ProcessIndex);
+
+		if ((Type >= static_cast<uint8>(ELoadingRecordedEventType::Max)) || !NameTable.IsValidIndex(LoadingTypeIndex) || !NameTable.IsValidIndex(ProcessIndex))
+		{
+			Reader.SetError();
+			break;
+		}
+
+		TimeMicros += DeltaMicros;
+
+		auto& Event{ Events.AddDefaulted_GetRef() };
+		Event.Time = TimeMicros / 1000000.0;
+		Event.Type = static_cast<ELoadingRecordedEventType>(Type);
+		Event.LoadingTypeName = FName(*NameTable[LoadingTypeIndex]);
+		Event.ProcessName = FName(*NameTable[ProcessIndex]);
+		Event.bFromObserver = (Flags & LoadingEventRecorder::Flag_FromObserver) != 0;
+		Event.bVisible = (Flags & LoadingEventRecorder::Flag_Visible) != 0;
+
+		if (LoadingEventRecorder::HasReason(Event.Type))
+		{
+			Reader << Event.Reason;
+		}
+	}
+
+	if (Reader.IsError())
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Discarded corrupted loading event recording (%s)"), *FilePath);
+		Reset();
+		return false;
+	}
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Loaded loading event recording (Events: %d)"), Events.Num());
+
+	return true;
+}
+
+bool FLoadingEventRecorder::Save(const FString& FilePath) const
+{
+	// Names are stored once in a table, so that each event only stores small indices
+
+	TArray<FString> NameTable;
+	TMap<FName, uint32> NameIndices;
+
+	auto GetNameIndex
+	{
+		[&NameTable, &NameIndices](FName Name)
+		{
+			if (const auto* FoundIndex{ NameIndices.Find(Name) })
+			{
+				return *FoundIndex;
+			}
+
+			const auto NewIndex{ static_cast<uint32>(NameTable.Add(Name.ToString())) };
+			NameIndices.Add(Name, NewIndex);
+
+			return NewIndex;
+		}
+	};
+
+	for (const auto& Event : Events)
+	{
+		GetNameIndex(Event.LoadingTypeName);
+		GetNameIndex(Event.ProcessName);
+	}
+
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+
+	auto Magic{ LoadingEventRecorder::FileMagic };
+	auto Version{ LoadingEventRecorder::FileVersion };
+	Writer << Magic;
+	Writer << Version;
+	Writer << NameTable;
+
+	auto NumEvents{ static_cast<uint32>(Events.Num()) };
+	Writer.SerializeIntPacked(NumEvents);
+
+	auto PrevTimeMicros{ 0ull };
+
+	for (const auto& Event : Events)
+	{
+		const auto TimeMicros{ FMath::Max(static_cast<uint64>(Event.Time * 1000000.0), PrevTimeMicros) };
+
+		auto Type{ static_cast<uint8>(Event.Type) };
+		auto Flags{ static_cast<uint8>((Event.bFromObserver ? LoadingEventRecorder::Flag_FromObserver : 0) | (Event.bVisible ? LoadingEventRecorder::Flag_Visible : 0)) };
+		auto DeltaMicros{ static_cast<uint32>(FMath::Min<uint64>(TimeMicros - PrevTimeMicros, MAX_uint32)) };
+		auto LoadingTypeIndex{ NameIndices[Event.LoadingTypeName] };
+		auto ProcessIndex{ NameIndices[Event.ProcessName] };
+
+		Writer << Type;
+		Writer << Flags;
+		Writer.SerializeIntPacked(DeltaMicros);
+		Writer.SerializeIntPacked(LoadingTypeIndex);
+		Writer.SerializeIntPacked(ProcessIndex);
+
+		if (LoadingEventRecorder::HasReason(Event.Type))
+		{
+			auto Reason{ Event.Reason };
+			Writer << Reason;
+		}
+
+		PrevTimeMicros += DeltaMicros;
+	}
+
+	if (!FFileHelper::SaveArrayToFile(Bytes, *FilePath))
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Failed to save loading event recording (%s)"), *FilePath);
+		return false;
+	}
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Saved loading event recording (Events: %d, Size: %d bytes, Path: %s)"), Events.Num(), Bytes.Num(), *FilePath);
+
+	return true;
+}
+
+void FLoadingEventRecorder::Reset()
+{
+	Events.Reset();
+	StartTime = 0.0;
+	bRecording = false;
+}
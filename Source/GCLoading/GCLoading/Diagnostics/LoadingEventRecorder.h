@@ -0,0 +1,176 @@
+﻿// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "GameplayTagContainer.h"
+
+
+/**
+ * Type of the event recorded from the loading screen subsystem
+ */
+enum class ELoadingRecordedEventType : uint8
+{
+	// Inputs fed back into the subsystem when replayed
+
+	ProcessAdded,
+	ProcessRemoved,
+	TypeRemoved,
+	ReasonChanged,
+	BatchBegin,
+	BatchEnd,
+
+	// Decisions made by the subsystem and compared when replayed
+
+	WidgetShown,
+	WidgetHidden,
+	WidgetSuppressed,
+	VisibilityChanged,
+
+	Max
+};
+
+
+/**
+ * Event recorded from the loading screen subsystem
+ */
+struct FLoadingRecordedEvent
+{
+public:
+	FLoadingRecordedEvent() {}
+
+public:
+	//
+	// Number of seconds from the start of the recording
+	//
+	double Time{ 0.0 };
+
+	//
+	// Type of the event
+	//
+	ELoadingRecordedEventType Type{ ELoadingRecordedEventType::Max };
+
+	//
+	// Name of the loading type tag of the event
+	//
+	FName LoadingTypeName{ NAME_None };
+
+	//
+	// Name of the loading process of the event
+	//
+	FName ProcessName{ NAME_None };
+
+	//
+	// Reason of the loading process, only recorded when it is added or changed
+	//
+	FString Reason;
+
+	//
+	// Whether the event was made by a loading observer while it was ticked
+	//
+	bool bFromObserver{ false };
+
+	//
+	// Whether the loading screen became displayed, only used by VisibilityChanged
+	//
+	bool bVisible{ false };
+
+public:
+	/**
+	 * Returns whether the event is fed back into the subsystem when replayed
+	 */
+	bool IsInput() const { return Type < ELoadingRecordedEventType::WidgetShown; }
+
+};
+
+
+/**
+ * Result of feeding a recording back into the loading screen subsystem
+ */
+struct FLoadingEventReplayResult
+{
+public:
+	FLoadingEventReplayResult() {}
+
+public:
+	//
+	// Number of recorded inputs fed into the subsystem
+	//
+	int32 NumInputs{ 0 };
+
+	//
+	// Number of visibility changes in the recording
+	//
+	int32 NumExpectedVisibilityChanges{ 0 };
+
+	//
+	// Number of visibility changes made by the subsystem while replaying
+	//
+	int32 NumVisibilityChanges{ 0 };
+
+	//
+	// Number of visibility changes that did not match the recording
+	//
+	int32 NumVisibilityMismatches{ 0 };
+
+	//
+	// Largest difference in seconds between the recorded and replayed visibility changes
+	//
+	double MaxVisibilityErrorSecs{ 0.0 };
+
+	//
+	// Number of frames the subsystem ticked while replaying
+	//
+	int32 NumFrames{ 0 };
+
+	//
+	// Cycles spent in the subsystem tick while replaying
+	//
+	uint64 OverheadCycles{ 0 };
+
+};
+
+
+/**
+ * Class that records the events of the loading screen subsystem to a compact binary file
+ */
+class GCLOADING_API FLoadingEventRecorder
+{
+public:
+	FLoadingEventRecorder() {}
+
+protected:
+	//
+	// List of recorded events, ordered by time
+	//
+	TArray<FLoadingRecordedEvent> Events;
+
+	//
+	// Time when the recording started
+	//
+	double StartTime{ 0.0 };
+
+	//
+	// Whether events are currently being recorded
+	//
+	bool bRecording{ false };
+
+public:
+	/**
+	 * Returns the file path under the Saved directory where the recording of the name is stored
+	 */
+	static FString GetFilePath(const FString& RecordingName);
+
+	void BeginRecording(double CurrentTime);
+	void EndRecording();
+
+	void Record(ELoadingRecordedEventType Type, double CurrentTime, FName LoadingTypeName, FName ProcessName, FString Reason = FString(), bool bFromObserver = false, bool bVisible = false);
+
+	bool Load(const FString& FilePath);
+	bool Save(const FString& FilePath) const;
+
+	void Reset();
+
+	bool IsRecording() const { return bRecording; }
+	const TArray<FLoadingRecordedEvent>& GetEvents() const { return Events; }
+
+};
@@ -0,0 +1,109 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "LoadingMemoryTracker.h"
+
+#include "GCLoadingLogs.h"
+
+#include "HAL/PlatformMemory.h"
+
+
+uint64 FLoadingMemoryTracker::GetUsedMemory()
+{
+	return FPlatformMemory::GetStats().UsedPhysical;
+}
+
+void FLoadingMemoryTracker::BeginTransition(FName MapName)
+{
+	const auto UsedBytes{ GetUsedMemory() };
+
+	CurrentStartPlatformPeakBytes = FPlatformMemory::GetStats().PeakUsedPhysical;
+
+	CurrentTransition = FLoadingMemoryTransition();
+	CurrentTransition.FromMapName = MapName;
+	CurrentTransition.ShowBytes = UsedBytes;
+	CurrentTransition.PeakBytes = UsedBytes;
+
+	CurrentStartTime = FPlatformTime::Seconds();
+	bTracking = true;
+}
+
+void FLoadingMemoryTracker::EndTransition(FName MapName)
+{
+	if (!bTracking)
+	{
+		return;
+	}
+
+	Sample();
+
+	CurrentTransition.ToMapName = MapName;
+	CurrentTransition.HideBytes = GetUsedMemory();
+	CurrentTransition.DisplayedSecs = FPlatformTime::Seconds() - CurrentStartTime;
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Loading screen memory (Map: %s -> %s, Show: %.1fMB, Peak: %.1fMB, Hide: %.1fMB)"),
+		*CurrentTransition.FromMapName.ToString(), *CurrentTransition.ToMapName.ToString(),
+		CurrentTransition.ShowBytes / (1024.0 * 1024.0), CurrentTransition.PeakBytes / (1024.0 * 1024.0), CurrentTransition.HideBytes / (1024.0 * 1024.0));
+
+	if (Transitions.Num() >= MaxTransitions)
+	{
+		Transitions.RemoveAt(0);
+	}
+
+	Transitions.Emplace(MoveTemp(CurrentTransition));
+
+	bTracking = false;
+}
+
+void FLoadingMemoryTracker::AddLoadingType(const FGameplayTag& LoadingTypeTag)
+{
+	if (bTracking)
+	{
+		CurrentTransition.LoadingTypeTags.AddUnique(LoadingTypeTag);
+	}
+}
+
+void FLoadingMemoryTracker::Sample()
+{
+	if (bTracking)
+	{
+		const auto Stats{ FPlatformMemory::GetStats() };
+
+		CurrentTransition.PeakBytes = FMath::Max<uint64>(CurrentTransition.PeakBytes, Stats.UsedPhysical);
+
+		if (Stats.PeakUsedPhysical > CurrentStartPlatformPeakBytes)
+		{
+			CurrentTransition.PeakBytes = FMath::Max<uint64>(CurrentTransition.PeakBytes, Stats.PeakUsedPhysical);
+		}
+	}
+}
+
+FString FLoadingMemoryTracker::BuildReport() const
+{
+	static constexpr auto BytesToMB{ 1.0 / (1024.0 * 1024.0) };
+
+	FString Report;
+	Report += FString::Printf(TEXT("Loading screen memory report (Transitions: %d)\n"), Transitions.Num());
+	Report += TEXT("FromMap,ToMap,LoadingTypes,ShowMB,PeakMB,HideMB,PeakDeltaMB,DisplayedSecs\n");
+
+	for (const auto& Transition : Transitions)
+	{
+		Report += FString::Printf(TEXT("%s,%s,%s,%.1f,%.1f,%.1f,%.1f,%.2f\n"),
+			*Transition.FromMapName.ToString(),
+			*Transition.ToMapName.ToString(),
+			*FString::JoinBy(Transition.LoadingTypeTags, TEXT(" "), [](const FGameplayTag& Tag) { return Tag.ToString(); }),
+			Transition.ShowBytes * BytesToMB,
+			Transition.PeakBytes * BytesToMB,
+			Transition.HideBytes * BytesToMB,
+			(static_cast<int64>(Transition.PeakBytes) - static_cast<int64>(Transition.ShowBytes)) * BytesToMB,
+			Transition.DisplayedSecs);
+	}
+
+	return Report;
+}
+
+void FLoadingMemoryTracker::Reset()
+{
+	Transitions.Reset();
+	CurrentTransition = FLoadingMemoryTransition();
+	bTracking = false;
+}
@@ -0,0 +1,121 @@
+﻿// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "GameplayTagContainer.h"
+
+
+/**
+ * Memory usage recorded while a loading screen was displayed
+ */
+struct FLoadingMemoryTransition
+{
+public:
+	FLoadingMemoryTransition() {}
+
+public:
+	//
+	// Name of the map when the loading screen was shown
+	//
+	FName FromMapName{ NAME_None };
+
+	//
+	// Name of the map when the loading screen was hidden
+	//
+	FName ToMapName{ NAME_None };
+
+	//
+	// List of loading types displayed during the transition
+	//
+	TArray<FGameplayTag> LoadingTypeTags;
+
+	//
+	// Memory used when the loading screen was shown
+	//
+	uint64 ShowBytes{ 0 };
+
+	//
+	// Highest memory used while the loading screen was displayed
+	//
+	uint64 PeakBytes{ 0 };
+
+	//
+	// Memory used when the loading screen was hidden
+	//
+	uint64 HideBytes{ 0 };
+
+	//
+	// Number of seconds the loading screen was displayed
+	//
+	double DisplayedSecs{ 0.0 };
+
+};
+
+
+/**
+ * Class that records memory high-water marks for each loading screen transition
+ */
+class GCLOADING_API FLoadingMemoryTracker
+{
+public:
+	FLoadingMemoryTracker() {}
+
+	/**
+	 * Number of transitions kept for the report
+	 */
+	static constexpr int32 MaxTransitions{ 32 };
+
+protected:
+	//
+	// List of completed transitions, ordered from oldest to newest
+	//
+	TArray<FLoadingMemoryTransition> Transitions;
+
+	//
+	// Transition currently being recorded
+	//
+	FLoadingMemoryTransition CurrentTransition;
+
+	//
+	// Process-wide peak memory reported by the platform when the current transition started
+	// 
+	// Tip:
+	//	If the platform peak rises during the transition, the new peak was reached while the loading screen was displayed.
+	//	This catches peaks inside blocking map loads that no tick can sample.
+	//
+	uint64 CurrentStartPlatformPeakBytes{ 0 };
+
+	//
+	// Time when the current transition started
+	//
+	double CurrentStartTime{ 0.0 };
+
+	//
+	// Whether a transition is currently being recorded
+	//
+	bool bTracking{ false };
+
+public:
+	static uint64 GetUsedMemory();
+
+	void BeginTransition(FName MapName);
+	void EndTransition(FName MapName);
+
+	void AddLoadingType(const FGameplayTag& LoadingTypeTag);
+
+	/**
+	 * Updates the peak memory of the current transition
+	 * 
+	 * Tip:
+	 *	Call this at points where memory is likely to be highest, such as before and after a map load.
+	 */
+	void Sample();
+
+	FString BuildReport() const;
+
+	void Reset();
+
+	bool IsTracking() const { return bTracking; }
+	const TArray<FLoadingMemoryTransition>& GetTransitions() const { return Transitions; }
+
+};
@@ -0,0 +1,95 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "LoadingScreenHitchDetector.h"
+
+#include "GCLoadingLogs.h"
+#include "GCLoadingStats.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+
+void FLoadingScreenHitchDetector::Initialize()
+{
+	Reset();
+
+	ReportFilePath = FPaths::ProjectLogDir() / FString::Printf(TEXT("LoadingScreenHitches-%s.csv"), *FDateTime::Now().ToString());
+}
+
+bool FLoadingScreenHitchDetector::SampleFrame(float FrameSecs, float ThresholdSecs)
+{
+	NumSampledFrames++;
+
+	return (ThresholdSecs > 0.0f) && (FrameSecs > ThresholdSecs);
+}
+
+void FLoadingScreenHitchDetector::AddHitch(FLoadingScreenHitch&& Hitch)
+{
+	INC_DWORD_STAT(STAT_GCLoading_Hitches);
+
+	UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Loading screen hitch detected (Frame: %.2fms, Processes: %s)"),
+		Hitch.FrameMs, *FString::JoinBy(Hitch.ProcessNames, TEXT(" "), [](const FName& Name) { return Name.ToString(); }));
+
+	if (Hitches.Num() < MaxHitches)
+	{
+		Hitches.Emplace(MoveTemp(Hitch));
+		return;
+	}
+
+	Hitches[NextHitchIndex] = MoveTemp(Hitch);
+	NextHitchIndex = (NextHitchIndex + 1) % MaxHitches;
+	NumDroppedHitches++;
+}
+
+TArray<FLoadingScreenHitch> FLoadingScreenHitchDetector::GetHitches() const
+{
+	TArray<FLoadingScreenHitch> OrderedHitches;
+	OrderedHitches.Reserve(Hitches.Num());
+
+	for (auto Index{ 0 }; Index < Hitches.Num(); ++Index)
+	{
+		OrderedHitches.Add(Hitches[(NextHitchIndex + Index) % Hitches.Num()]);
+	}
+
+	return OrderedHitches;
+}
+
+bool FLoadingScreenHitchDetector::WriteReport() const
+{
+	if (Hitches.IsEmpty() || ReportFilePath.IsEmpty())
+	{
+		return false;
+	}
+
+	FString Report;
+	Report += FString::Printf(TEXT("SampledFrames,%d\n"), NumSampledFrames);
+	Report += FString::Printf(TEXT("DroppedHitches,%d\n"), NumDroppedHitches);
+	Report += TEXT("Time,FrameMs,LoadingTypes,Processes\n");
+
+	for (const auto& Hitch : GetHitches())
+	{
+		Report += FString::Printf(TEXT("%s,%.2f,%s,%s\n"),
+			*Hitch.Time.ToString(),
+			Hitch.FrameMs,
+			*FString::JoinBy(Hitch.LoadingTypeTags, TEXT(" "), [](const FGameplayTag& Tag) { return Tag.ToString(); }),
+			*FString::JoinBy(Hitch.ProcessNames, TEXT(" "), [](const FName& Name) { return Name.ToString(); }));
+	}
+
+	if (!FFileHelper::SaveStringToFile(Report, *ReportFilePath))
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Failed to write loading screen hitch report (%s)"), *ReportFilePath);
+		return false;
+	}
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Wrote loading screen hitch report (Hitches: %d, Dropped: %d, Path: %s)"), Hitches.Num(), NumDroppedHitches, *ReportFilePath);
+
+	return true;
+}
+
+void FLoadingScreenHitchDetector::Reset()
+{
+	Hitches.Reset();
+	NextHitchIndex = 0;
+	NumDroppedHitches = 0;
+	NumSampledFrames = 0;
+}
@@ -0,0 +1,108 @@
+﻿// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "GameplayTagContainer.h"
+
+
+/**
+ * Frame that exceeded the hitch threshold while the loading screen was displayed
+ */
+struct FLoadingScreenHitch
+{
+public:
+	FLoadingScreenHitch() {}
+
+public:
+	//
+	// Time when the hitch was detected
+	//
+	FDateTime Time;
+
+	//
+	// Duration of the frame in milliseconds
+	//
+	float FrameMs{ 0.0f };
+
+	//
+	// List of loading processes that were active during the frame
+	//
+	TArray<FName> ProcessNames;
+
+	//
+	// List of loading types that were active during the frame
+	//
+	TArray<FGameplayTag> LoadingTypeTags;
+
+};
+
+
+/**
+ * Class that collects frames over the threshold while the loading screen is displayed and writes them to a report
+ */
+class GCLOADING_API FLoadingScreenHitchDetector
+{
+public:
+	FLoadingScreenHitchDetector() {}
+
+	/**
+	 * Number of hitches kept for the report
+	 */
+	static constexpr int32 MaxHitches{ 256 };
+
+protected:
+	//
+	// Ring buffer of the most recent hitches detected in this session
+	// 
+	// Tip:
+	//	Once the buffer is full, the oldest hitch is overwritten and counted as dropped.
+	//
+	TArray<FLoadingScreenHitch> Hitches;
+
+	//
+	// Index in Hitches where the next hitch is written once the buffer is full
+	//
+	int32 NextHitchIndex{ 0 };
+
+	//
+	// Number of hitches overwritten because the buffer was full
+	//
+	int32 NumDroppedHitches{ 0 };
+
+	//
+	// Number of frames sampled while the loading screen was displayed
+	//
+	int32 NumSampledFrames{ 0 };
+
+	//
+	// Path of the report file for this session
+	//
+	FString ReportFilePath;
+
+public:
+	void Initialize();
+
+	/**
+	 * Samples the frame and returns whether it was a hitch
+	 */
+	bool SampleFrame(float FrameSecs, float ThresholdSecs);
+
+	void AddHitch(FLoadingScreenHitch&& Hitch);
+
+	/**
+	 * Writes the detected hitches to the report file of the session
+	 */
+	bool WriteReport() const;
+
+	void Reset();
+
+	int32 GetNumHitches() const { return Hitches.Num(); }
+	int32 GetNumDroppedHitches() const { return NumDroppedHitches; }
+	int32 GetNumSampledFrames() const { return NumSampledFrames; }
+
+	/**
+	 * Returns the kept hitches from oldest to newest
+	 */
+	TArray<FLoadingScreenHitch> GetHitches() const;
+
+};
@@ -0,0 +1,132 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "LoadingWatchdogThread.h"
+
+#include "GCLoadingLogs.h"
+
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformStackWalk.h"
+#include "HAL/RunnableThread.h"
+
+
+FLoadingWatchdogThread::~FLoadingWatchdogThread()
+{
+	Shutdown();
+}
+
+void FLoadingWatchdogThread::Start(double InCheckIntervalSecs)
+{
+	if (Thread)
+	{
+		return;
+	}
+
+	CheckIntervalSecs = InCheckIntervalSecs;
+	bStopRequested = false;
+
+	StackBuffer.SetNumZeroed(64 * 1024);
+
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("LoadingWatchdog"), 0, TPri_BelowNormal);
+}
+
+void FLoadingWatchdogThread::Shutdown()
+{
+	if (!Thread)
+	{
+		return;
+	}
+
+	// Kill waits for the thread to exit after calling Stop
+
+	Thread->Kill(true);
+
+	delete Thread;
+	Thread = nullptr;
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+
+	StackBuffer.Empty();
+}
+
+void FLoadingWatchdogThread::SetDeadline(double InDeadline, const FString& Cause)
+{
+	FScopeLock Lock(&DeadlineLock);
+
+	// The game thread may find the stall before this thread wakes, so keep the passed deadline for the dump
+
+	if ((Deadline > 0.0) && (FPlatformTime::Seconds() >= Deadline) && !bDumpPending)
+	{
+		PendingDumpCause = MoveTemp(DeadlineCause);
+		bDumpPending = true;
+
+		if (WakeEvent)
+		{
+			WakeEvent->Trigger();
+		}
+	}
+
+	Deadline = InDeadline;
+	DeadlineCause = Cause;
+}
+
+uint32 FLoadingWatchdogThread::Run()
+{
+	while (!bStopRequested)
+	{
+		WakeEvent->Wait(FTimespan::FromSeconds(CheckIntervalSecs));
+
+		if (bStopRequested)
+		{
+			break;
+		}
+
+		FString Cause;
+
+		{
+			FScopeLock Lock(&DeadlineLock);
+
+			// Each deadline is dumped only once
+
+			if (bDumpPending)
+			{
+				Cause = MoveTemp(PendingDumpCause);
+				bDumpPending = false;
+			}
+			else if ((Deadline > 0.0) && (FPlatformTime::Seconds() >= Deadline))
+			{
+				Cause = MoveTemp(DeadlineCause);
+				Deadline = 0.0;
+			}
+			else
+			{
+				continue;
+			}
+		}
+
+		DumpGameThreadStack(Cause);
+	}
+
+	return 0;
+}
+
+void FLoadingWatchdogThread::Stop()
+{
+	bStopRequested = true;
+
+	if (WakeEvent)
+	{
+		WakeEvent->Trigger();
+	}
+}
+
+void FLoadingWatchdogThread::DumpGameThreadStack(const FString& Cause)
+{
+	StackBuffer[0] = '\0';
+
+	FPlatformStackWalk::ThreadStackWalkAndDump(StackBuffer.GetData(), StackBuffer.Num(), 0, GGameThreadId);
+
+	UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Loading watchdog game thread call stack (%s):\n%s"), *Cause, ANSI_TO_TCHAR(StackBuffer.GetData()));
+}
@@ -0,0 +1,99 @@
+﻿// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "HAL/Runnable.h"
+#include "HAL/CriticalSection.h"
+
+#include <atomic>
+
+class FRunnableThread;
+class FEvent;
+
+
+/**
+ * Thread that dumps the game thread call stack when the earliest watchdog deadline passes
+ * 
+ * Tip:
+ *	The game thread may be blocked by the stalled loading (such as a blocking map load), so the deadline is checked here.
+ *	Reporting in the log and removing the stalled loading still run on the game thread.
+ */
+class GCLOADING_API FLoadingWatchdogThread : public FRunnable
+{
+public:
+	FLoadingWatchdogThread() {}
+	virtual ~FLoadingWatchdogThread();
+
+protected:
+	//
+	// Thread running this watchdog
+	//
+	FRunnableThread* Thread{ nullptr };
+
+	//
+	// Event used to wake the thread when it is stopped
+	//
+	FEvent* WakeEvent{ nullptr };
+
+	//
+	// Interval in seconds at which the deadline is checked
+	//
+	double CheckIntervalSecs{ 1.0 };
+
+	//
+	// Lock for the deadline and the pending dump
+	//
+	mutable FCriticalSection DeadlineLock;
+
+	//
+	// Platform time at which the game thread call stack is dumped (0 if none)
+	//
+	double Deadline{ 0.0 };
+
+	//
+	// Description of the loading that owns the deadline
+	//
+	FString DeadlineCause;
+
+	//
+	// Description of the passed deadline that was replaced before the thread dumped it
+	//
+	FString PendingDumpCause;
+
+	//
+	// Whether a passed deadline was replaced before the thread dumped it
+	//
+	bool bDumpPending{ false };
+
+	//
+	// Buffer for the game thread call stack, allocated once when the thread starts
+	//
+	TArray<ANSICHAR> StackBuffer;
+
+	//
+	// Whether the thread has been requested to stop
+	//
+	std::atomic<bool> bStopRequested{ false };
+
+public:
+	void Start(double InCheckIntervalSecs);
+	void Shutdown();
+
+	bool IsRunning() const { return Thread != nullptr; }
+
+	/**
+	 * Sets the platform time at which the game thread call stack is dumped
+	 * 
+	 * Tip:
+	 *	If InDeadline is 0 or less, no call stack is dumped.
+	 *	If the current deadline has already passed, it is still dumped once.
+	 */
+	void SetDeadline(double InDeadline, const FString& Cause);
+
+protected:
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+	void DumpGameThreadStack(const FString& Cause);
+
+};
@@ -7,3 +7,4 @@
 // LoadingType
 
 UE_DEFINE_GAMEPLAY_TAG(TAG_LoadingType_Fullscreen, "LoadingType.Fullscreen");
+UE_DEFINE_GAMEPLAY_TAG(TAG_LoadingType_Overlay, "LoadingType.Overlay");
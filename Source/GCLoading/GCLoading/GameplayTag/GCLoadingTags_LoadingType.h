@@ -9,3 +9,4 @@
 // LoadingType
 
 GCLOADING_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_LoadingType_Fullscreen);
+GCLOADING_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_LoadingType_Overlay);
@@ -0,0 +1,131 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "LoadingHistoryDatabase.h"
+
+#include "GCLoadingLogs.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+
+namespace LoadingHistoryDatabase
+{
+	static constexpr uint32 FileMagic{ 0x4C44484E };	// "LDHN"
+	static constexpr int32 FileVersion{ 1 };
+}
+
+
+// FLoadingHistorySamples
+
+void FLoadingHistorySamples::AddSample(float Duration, int32 MaxSamples)
+{
+	Durations.Add(Duration);
+
+	// Discard the oldest samples
+
+	const auto NumToRemove{ Durations.Num() - FMath::Max(MaxSamples, 1) };
+
+	if (NumToRemove > 0)
+	{
+		Durations.RemoveAt(0, NumToRemove);
+	}
+}
+
+float FLoadingHistorySamples::GetPercentile(float Percentile) const
+{
+	if (Durations.IsEmpty())
+	{
+		return 0.0f;
+	}
+
+	auto Sorted{ Durations };
+	Sorted.Sort();
+
+	const auto Index{ FMath::Clamp(FMath::CeilToInt(Percentile * Sorted.Num()) - 1, 0, Sorted.Num() - 1) };
+
+	return Sorted[Index];
+}
+
+
+// FLoadingHistoryDatabase
+
+FString FLoadingHistoryDatabase::GetDefaultFilePath(int32 PIEInstance)
+{
+	const auto FileName{ (PIEInstance == INDEX_NONE) ? FString(TEXT("LoadingHistory.bin")) : FString::Printf(TEXT("LoadingHistory_PIE%d.bin"), PIEInstance) };
+
+	return FPaths::ProjectSavedDir() / TEXT("Loading") / FileName;
+}
+
+bool FLoadingHistoryDatabase::Load(const FString& FilePath)
+{
+	Reset();
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FilePath, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+
+	auto Magic{ 0u };
+	auto Version{ 0 };
+	Reader << Magic;
+	Reader << Version;
+
+	if ((Magic != LoadingHistoryDatabase::FileMagic) || (Version != LoadingHistoryDatabase::FileVersion))
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Discarded loading history with unknown format (%s)"), *FilePath);
+		return false;
+	}
+
+	Reader << Entries;
+
+	if (Reader.IsError())
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Discarded corrupted loading history (%s)"), *FilePath);
+		Reset();
+		return false;
+	}
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Loaded loading history (Entries: %d)"), Entries.Num());
+
+	return true;
+}
+
+bool FLoadingHistoryDatabase::Save(const FString& FilePath)
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+
+	auto Magic{ LoadingHistoryDatabase::FileMagic };
+	auto Version{ LoadingHistoryDatabase::FileVersion };
+	Writer << Magic;
+	Writer << Version;
+	Writer << Entries;
+
+	if (!FFileHelper::SaveArrayToFile(Bytes, *FilePath))
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Failed to save loading history (%s)"), *FilePath);
+		return false;
+	}
+
+	bDirty = false;
+
+	return true;
+}
+
+void FLoadingHistoryDatabase::Reset()
+{
+	Entries.Reset();
+	bDirty = false;
+}
+
+
+void FLoadingHistoryDatabase::RecordDuration(const FLoadingHistoryKey& Key, float Duration, int32 MaxSamples)
+{
+	Entries.FindOrAdd(Key).AddSample(Duration, MaxSamples);
+	bDirty = true;
+}
@@ -0,0 +1,133 @@
+﻿// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "GameplayTagContainer.h"
+
+
+/**
+ * Key identifying the history of a loading type or a loading process on a map
+ */
+struct FLoadingHistoryKey
+{
+public:
+	FLoadingHistoryKey() {}
+
+	FLoadingHistoryKey(FName InMapName, FName InLoadingTypeName, FName InProcessName)
+		: MapName(InMapName), LoadingTypeName(InLoadingTypeName), ProcessName(InProcessName)
+	{}
+
+public:
+	//
+	// Name of the map on which the loading was performed
+	//
+	FName MapName{ NAME_None };
+
+	//
+	// Tag name of the loading type
+	//
+	FName LoadingTypeName{ NAME_None };
+
+	//
+	// Name of the loading process (NAME_None for the whole loading type)
+	//
+	FName ProcessName{ NAME_None };
+
+public:
+	bool operator==(const FLoadingHistoryKey& Other) const
+	{
+		return (MapName == Other.MapName) && (LoadingTypeName == Other.LoadingTypeName) && (ProcessName == Other.ProcessName);
+	}
+
+	friend uint32 GetTypeHash(const FLoadingHistoryKey& Key)
+	{
+		return HashCombine(HashCombine(GetTypeHash(Key.MapName), GetTypeHash(Key.LoadingTypeName)), GetTypeHash(Key.ProcessName));
+	}
+
+	friend FArchive& operator<<(FArchive& Ar, FLoadingHistoryKey& Key)
+	{
+		Ar << Key.MapName;
+		Ar << Key.LoadingTypeName;
+		Ar << Key.ProcessName;
+		return Ar;
+	}
+
+};
+
+
+/**
+ * Recent durations recorded for a loading type or a loading process
+ */
+struct FLoadingHistorySamples
+{
+public:
+	FLoadingHistorySamples() {}
+
+public:
+	//
+	// List of durations in seconds, ordered from oldest to newest
+	//
+	TArray<float> Durations;
+
+public:
+	void AddSample(float Duration, int32 MaxSamples);
+
+	/**
+	 * Returns the duration at the percentile (0.0 - 1.0) of the recorded samples
+	 */
+	float GetPercentile(float Percentile) const;
+
+	float GetMedian() const { return GetPercentile(0.5f); }
+
+	int32 Num() const { return Durations.Num(); }
+
+	friend FArchive& operator<<(FArchive& Ar, FLoadingHistorySamples& Samples)
+	{
+		Ar << Samples.Durations;
+		return Ar;
+	}
+
+};
+
+
+/**
+ * Small persistent database of loading durations per map and loading type
+ */
+class GCLOADING_API FLoadingHistoryDatabase
+{
+public:
+	FLoadingHistoryDatabase() {}
+
+protected:
+	//
+	// Mapping list of history keys and their recorded durations
+	//
+	TMap<FLoadingHistoryKey, FLoadingHistorySamples> Entries;
+
+	//
+	// Whether there are changes that have not been saved yet
+	//
+	bool bDirty{ false };
+
+public:
+	/**
+	 * Returns the file path under the Saved directory where the history is stored
+	 * 
+	 * Tip:
+	 *	Each play in editor instance uses its own file, since they run in the same process and would overwrite each other.
+	 */
+	static FString GetDefaultFilePath(int32 PIEInstance = INDEX_NONE);
+
+	bool Load(const FString& FilePath);
+	bool Save(const FString& FilePath);
+
+	void Reset();
+
+	bool IsDirty() const { return bDirty; }
+
+public:
+	void RecordDuration(const FLoadingHistoryKey& Key, float Duration, int32 MaxSamples);
+
+	const FLoadingHistorySamples* FindSamples(const FLoadingHistoryKey& Key) const { return Entries.Find(Key); }
+
+};
@@ -9,6 +9,40 @@
 #include "LoadingDeveloperSettings.generated.h"
 
 
+/**
+ * How long the widget class of a loading type stays in memory
+ */
+UENUM(BlueprintType)
+enum class ELoadingWidgetResidencyPolicy : uint8
+{
+	// Once loaded, the widget class stays in memory for the whole session
+	AlwaysResident,
+
+	// The widget class is released after the loading screen is hidden
+	ReleaseAfterHide,
+
+	// The widget class is released after the loading screen is hidden and loaded again ahead of the next predicted use
+	PreloadBeforeUse
+};
+
+
+/**
+ * How the loading widget is rendered
+ */
+UENUM(BlueprintType)
+enum class ELoadingWidgetRenderMode : uint8
+{
+	// The widget is prepassed and painted every frame
+	Default,
+
+	// The widget is cached in an invalidation panel and only invalidated regions are painted again
+	Invalidation,
+
+	// The widget is rendered to a retained render target that is redrawn at a reduced rate
+	Retainer
+};
+
+
 /**
  * Definition data of widgets to be displayed for loading type
  */
@@ -38,6 +72,40 @@ public:
 	UPROPERTY(EditAnywhere, meta = (ClampMin = 0.00))
 	float AdditionalSecs{ 2.0f };
 
+	//
+	// Number of seconds to wait after loading starts before displaying the widget
+	// 
+	// Tip:
+	//	Loading that ends within this time never displays the widget.
+	//
+	UPROPERTY(EditAnywhere, meta = (ClampMin = 0.00, Units = "Seconds"))
+	float ShowDelaySecs{ 0.0f };
+
+	//
+	// Minimum number of seconds to keep displaying the widget once it is displayed
+	//
+	UPROPERTY(EditAnywhere, meta = (ClampMin = 0.00, Units = "Seconds"))
+	float MinVisibleSecs{ 0.0f };
+
+	//
+	// Number of seconds to keep displaying the widget after loading ends so that it can be reused when loading of the same type starts again
+	// 
+	// Tip:
+	//	The widget stays visible during this window, so back-to-back loading does not flicker.
+	//	The widget is kept while seamless travel is in progress, so a single instance is used for the whole travel.
+	//
+	UPROPERTY(EditAnywhere, meta = (ClampMin = 0.00, Units = "Seconds"))
+	float ReuseGraceSecs{ 0.0f };
+
+	//
+	// Number of seconds after which loading of this type is treated as stalled by the watchdog
+	// 
+	// Tip:
+	//	If 0, the loading type is never treated as stalled.
+	//
+	UPROPERTY(EditAnywhere, meta = (ClampMin = 0.00, Units = "Seconds"))
+	float TimeoutSecs{ 0.0f };
+
 	//
 	// Whether input should be blocked during loading?
 	//
@@ -50,6 +118,46 @@ public:
 	UPROPERTY(EditAnywhere)
 	bool bSavingPerfomance{ true };
 
+	//
+	// Whether the widget covers the whole screen with opaque content
+	// 
+	// Tip:
+	//	Widgets with a lower ZOrder than a displayed opaque fullscreen widget are collapsed and stop ticking until it is hidden.
+	//
+	UPROPERTY(EditAnywhere)
+	bool bOpaqueFullscreen{ false };
+
+	//
+	// How long the widget class and the assets it references stay in memory
+	//
+	UPROPERTY(EditAnywhere)
+	ELoadingWidgetResidencyPolicy ResidencyPolicy{ ELoadingWidgetResidencyPolicy::AlwaysResident };
+
+	//
+	// How the widget is rendered
+	// 
+	// Tip:
+	//	Mostly static widgets can save game thread time by only painting the regions that change, such as a spinner.
+	//
+	UPROPERTY(EditAnywhere)
+	ELoadingWidgetRenderMode RenderMode{ ELoadingWidgetRenderMode::Default };
+
+	//
+	// Number of frames between redraws when rendered in Retainer mode
+	//
+	UPROPERTY(EditAnywhere, meta = (ClampMin = 1, EditCondition = "RenderMode == ELoadingWidgetRenderMode::Retainer"))
+	int32 RetainerRedrawFrameInterval{ 2 };
+
+	//
+	// Frame rate at which the game is presented while the widget is displayed
+	// 
+	// Tip:
+	//	If 0, the frame rate is not limited.
+	//	If multiple widgets with a limit are displayed, the lowest limit is used.
+	//
+	UPROPERTY(EditAnywhere, meta = (ClampMin = 0.00, Units = "Hertz"))
+	float TargetPresentationRate{ 0.0f };
+
 };
 
 
@@ -80,6 +188,116 @@ public:
 	UPROPERTY(Config, EditAnywhere, Category = "LoadingScreen", meta = (MetaClass = "/Script/GCLoading.LoadingObserver"))
 	TArray<FSoftClassPath> ObserverClassesToEnable;
 
+	//
+	// Whether loading observers whose evaluation is thread-safe are evaluated in parallel on task graph workers
+	// 
+	// Tip:
+	//	The cost of each observer can be compared with and without this option in "stat GCLoading".
+	//	"Evaluate Observers In Parallel" is the time the game thread waits for the parallel evaluation.
+	//
+	UPROPERTY(Config, EditAnywhere, Category = "LoadingScreen")
+	bool bEvaluateObserversInParallel{ true };
+
+public:
+	//
+	// Whether to record loading durations per map and loading type under the Saved directory
+	//
+	UPROPERTY(Config, EditAnywhere, Category = "LoadingScreen|History")
+	bool bEnableLoadingHistory{ true };
+
+	//
+	// Number of recent durations kept for each map, loading type and loading process
+	//
+	UPROPERTY(Config, EditAnywhere, Category = "LoadingScreen|History", meta = (ClampMin = 1, EditCondition = "bEnableLoadingHistory"))
+	int32 LoadingHistoryMaxSamples{ 20 };
+
+	//
+	// Number of recorded durations required before a slow loading is reported
+	//
+	UPROPERTY(Config, EditAnywhere, Category = "LoadingScreen|History", meta = (ClampMin = 1, EditCondition = "bEnableLoadingHistory"))
+	int32 LoadingHistoryMinSamplesForRegression{ 5 };
+
+public:
+	//
+	// Whether to detect frames over the threshold while the loading screen is displayed and write them to a report
+	//
+	UPROPERTY(Config, EditAnywhere, Category = "LoadingScreen|Diagnostics")
+	bool bDetectLoadingScreenHitches{ false };
+
+	//
+	// Frame time in milliseconds above which a frame is treated as a hitch
+	//
+	UPROPERTY(Config, EditAnywhere, Category = "LoadingScreen|Diagnostics", meta = (ClampMin = 1.00, Units = "Milliseconds", EditCondition = "bDetectLoadingScreenHitches"))
+	float LoadingScreenHitchThresholdMs{ 50.0f };
+
+public:
+	//
+	// Whether to release cached memory when an opaque fullscreen loading screen is shown, before the new map starts loading
+	//
+	UPROPERTY(Config, EditAnywhere, Category = "LoadingScreen|MemoryTrim")
+	bool bTrimMemoryOnFullscreenLoading{ false };
+
+	//
+	// Whether to purge objects that are no longer referenced
+	//
+	UPROPERTY(Config, EditAnywhere, Category = "LoadingScreen|MemoryTrim", meta = (EditCondition = "bTrimMemoryOnFullscreenLoading"))
+	bool bTrimPurgeUnreferencedObjects{ true };
+
+	//
+	// Whether to flush rendering commands so that released render resources are deleted
+	//
+	UPROPERTY(Config, EditAnywhere, Category = "LoadingScreen|MemoryTrim", meta = (EditCondition = "bTrimMemoryOnFullscreenLoading"))
+	bool bTrimFlushRenderResources{ true };
+
+	//
+	// Whether to free unused render targets in the render target pool
+	//
+	UPROPERTY(Config, EditAnywhere, Category = "LoadingScreen|MemoryTrim", meta = (EditCondition = "bTrimMemoryOnFullscreenLoading"))
+	bool bTrimPooledRenderTargets{ true };
+
+	//
+	// Whether to return cached free memory of the allocator to the system
+	//
+	UPROPERTY(Config, EditAnywhere, Category = "LoadingScreen|MemoryTrim", meta = (EditCondition = "bTrimMemoryOnFullscreenLoading"))
+	bool bTrimAllocator{ true };
+
+public:
+	//
+	// Number of seconds after which a single loading process is treated as stalled by the watchdog
+	// 
+	// Tip:
+	//	If 0, loading processes are never treated as stalled.
+	//	Timeouts for the whole loading type can be set in each loading screen definition.
+	//
+	UPROPERTY(Config, EditAnywhere, Category = "LoadingScreen|Watchdog", meta = (ClampMin = 0.00, Units = "Seconds"))
+	float LoadingProcessTimeoutSecs{ 0.0f };
+
+	//
+	// Whether to remove the stalled loading processes after dumping the diagnostics
+	//
+	UPROPERTY(Config, EditAnywhere, Category = "LoadingScreen|Watchdog")
+	bool bForceRemoveTimedOutLoadingProcesses{ false };
+
+public:
+	//
+	// Whether to track loading without displaying any widget when the application cannot render, such as with NullRHI
+	// 
+	// Tip:
+	//	Headless mode can also be forced with the "-LoadingScreenHeadless" command line option.
+	//
+	UPROPERTY(Config, EditAnywhere, Category = "LoadingScreen|Headless")
+	bool bUseHeadlessModeWhenCannotRender{ true };
+
+public:
+	//
+	// Percentage of the frame time at the limited presentation rate that the game thread may spend on async loading
+	// 
+	// Tip:
+	//	The frame time freed by limiting the presentation rate is given to loading instead of being slept away.
+	//
+	UPROPERTY(Config, EditAnywhere, Category = "LoadingScreen|Presentation", meta = (ClampMin = 0.00, ClampMax = 1.00))
+	float PresentationRateAsyncLoadingTimeShare{ 0.8f };
+
 public:
 	//
 	// After the actual loading is completed in the test play in the editor, do you want to show an additional loading screen?
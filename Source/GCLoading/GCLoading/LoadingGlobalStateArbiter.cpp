@@ -0,0 +1,337 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "LoadingGlobalStateArbiter.h"
+
+#include "LoadingScreenInputPreProcessor.h"
+#include "GCLoadingLogs.h"
+
+#include "Framework/Application/SlateApplication.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/ThreadHeartBeat.h"
+#include "Misc/ConfigCacheIni.h"
+#include "ShaderPipelineCache.h"
+
+
+/**
+ * Target that changes the states of the running engine
+ */
+class FLoadingGlobalStateEngineTarget : public ILoadingGlobalStateTarget
+{
+protected:
+	TSharedPtr<IInputProcessor> InputPreProcessor;
+
+public:
+	virtual void SetSavingPerformance(bool bSaving) override
+	{
+		if (bSaving)
+		{
+			// Change shader batch mode
+
+			FShaderPipelineCache::SetBatchMode(FShaderPipelineCache::BatchMode::Fast);
+
+			// Obtain and apply HangDurationMultiplier from GConfig on the load screen
+
+			auto HangDurationMultiplier{ 0.0 };
+			if (!GConfig || !GConfig->GetDouble(TEXT("Core.System"), TEXT("LoadingScreenHangDurationMultiplier"), HangDurationMultiplier, GEngineIni))
+			{
+				HangDurationMultiplier = 1.0;
+			}
+
+			FThreadHeartBeat::Get().SetDurationMultiplier(HangDurationMultiplier);
+			FGameThreadHitchHeartBeat::Get().SuspendHeartBeat();
+		}
+		else
+		{
+			// Restore the original settings
+
+			FShaderPipelineCache::SetBatchMode(FShaderPipelineCache::BatchMode::Background);
+
+			FThreadHeartBeat::Get().SetDurationMultiplier(1.0);
+			FGameThreadHitchHeartBeat::Get().ResumeHeartBeat();
+		}
+	}
+
+	virtual bool RegisterInputPreProcessor() override
+	{
+		if (!FSlateApplication::IsInitialized())
+		{
+			return false;
+		}
+
+		InputPreProcessor = MakeShareable<FLoadingScreenInputPreProcessor>(new FLoadingScreenInputPreProcessor());
+		FSlateApplication::Get().RegisterInputPreProcessor(InputPreProcessor, 0);
+
+		return true;
+	}
+
+	virtual void UnregisterInputPreProcessor() override
+	{
+		if (InputPreProcessor.IsValid() && FSlateApplication::IsInitialized())
+		{
+			FSlateApplication::Get().UnregisterInputPreProcessor(InputPreProcessor);
+		}
+
+		InputPreProcessor.Reset();
+	}
+
+	virtual IConsoleVariable* FindConsoleVariable(const TCHAR* Name) const override
+	{
+		return IConsoleManager::Get().FindConsoleVariable(Name);
+	}
+};
+
+
+FLoadingGlobalStateArbiter::FLoadingGlobalStateArbiter()
+	: Target(GetEngineTarget())
+{
+}
+
+FLoadingGlobalStateArbiter::~FLoadingGlobalStateArbiter()
+{
+	CancelPendingInputPreProcessor();
+}
+
+FLoadingGlobalStateArbiter& FLoadingGlobalStateArbiter::Get()
+{
+	static FLoadingGlobalStateArbiter Instance;
+	return Instance;
+}
+
+ILoadingGlobalStateTarget& FLoadingGlobalStateArbiter::GetEngineTarget()
+{
+	static FLoadingGlobalStateEngineTarget Instance;
+	return Instance;
+}
+
+
+// Saving Performance
+
+void FLoadingGlobalStateArbiter::AcquireSavingPerformance()
+{
+	check(IsInGameThread());
+
+	if (SavingPerformanceRefCount++ > 0)
+	{
+		return;
+	}
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Global Saving Performance: ENABLED"));
+
+	Target.SetSavingPerformance(true);
+}
+
+void FLoadingGlobalStateArbiter::ReleaseSavingPerformance()
+{
+	check(IsInGameThread());
+
+	if (!ensure(SavingPerformanceRefCount > 0) || (--SavingPerformanceRefCount > 0))
+	{
+		return;
+	}
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Global Saving Performance: DISABLED"));
+
+	Target.SetSavingPerformance(false);
+}
+
+
+// Input Block
+
+void FLoadingGlobalStateArbiter::AcquireInputBlock()
+{
+	check(IsInGameThread());
+
+	if (InputBlockRefCount++ > 0)
+	{
+		return;
+	}
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Global Input Block: ENABLED"));
+
+	// Input may be blocked before Slate is initialized, so keep retrying until the block is released
+
+	if (UpdatePendingInputPreProcessor() && !PendingInputPreProcessorHandle.IsValid())
+	{
+		PendingInputPreProcessorHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda(
+			[this](float DeltaTime)
+			{
+				if (UpdatePendingInputPreProcessor())
+				{
+					return true;
+				}
+
+				PendingInputPreProcessorHandle.Reset();
+				return false;
+			}));
+	}
+}
+
+void FLoadingGlobalStateArbiter::ReleaseInputBlock()
+{
+	check(IsInGameThread());
+
+	if (!ensure(InputBlockRefCount > 0) || (--InputBlockRefCount > 0))
+	{
+		return;
+	}
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Global Input Block: DISABLED"));
+
+	CancelPendingInputPreProcessor();
+
+	if (bInputPreProcessorRegistered)
+	{
+		bInputPreProcessorRegistered = false;
+
+		Target.UnregisterInputPreProcessor();
+	}
+}
+
+bool FLoadingGlobalStateArbiter::UpdatePendingInputPreProcessor()
+{
+	if ((InputBlockRefCount > 0) && !bInputPreProcessorRegistered)
+	{
+		bInputPreProcessorRegistered = Target.RegisterInputPreProcessor();
+
+		if (bInputPreProcessorRegistered)
+		{
+			UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Input preprocessor registered"));
+		}
+	}
+
+	return (InputBlockRefCount > 0) && !bInputPreProcessorRegistered;
+}
+
+void FLoadingGlobalStateArbiter::CancelPendingInputPreProcessor()
+{
+	if (PendingInputPreProcessorHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(PendingInputPreProcessorHandle);
+		PendingInputPreProcessorHandle.Reset();
+	}
+}
+
+
+// Presentation Rate
+
+void FLoadingGlobalStateArbiter::RequestPresentationRate(const void* Requester, float Rate, float AsyncLoadingTimeShare)
+{
+	check(IsInGameThread());
+
+	if (Rate > 0.0f)
+	{
+		auto& Request{ PresentationRateRequests.FindOrAdd(Requester) };
+		Request.Rate = Rate;
+		Request.AsyncLoadingTimeShare = AsyncLoadingTimeShare;
+	}
+	else
+	{
+		PresentationRateRequests.Remove(Requester);
+	}
+
+	// Apply the lowest requested rate with the share of the requester that requested it
+
+	FPresentationRateRequest NewRequest;
+
+	for (const auto& KVP : PresentationRateRequests)
+	{
+		if ((NewRequest.Rate <= 0.0f) || (KVP.Value.Rate < NewRequest.Rate))
+		{
+			NewRequest = KVP.Value;
+		}
+	}
+
+	if ((AppliedPresentationRate != NewRequest.Rate) || (AppliedAsyncLoadingTimeShare != NewRequest.AsyncLoadingTimeShare))
+	{
+		if (NewRequest.Rate > 0.0f)
+		{
+			ApplyPresentationRate(NewRequest.Rate, NewRequest.AsyncLoadingTimeShare);
+		}
+		else
+		{
+			RestorePresentationRate();
+		}
+	}
+}
+
+void FLoadingGlobalStateArbiter::ApplyPresentationRate(float Rate, float AsyncLoadingTimeShare)
+{
+	auto* CVarMaxFPS{ GetMaxFPSCVar() };
+	auto* CVarAsyncLoadingTimeLimit{ GetAsyncLoadingTimeLimitCVar() };
+	auto* CVarAsyncLoadingUseFullTimeLimit{ GetAsyncLoadingUseFullTimeLimitCVar() };
+
+	// Save the original values only when the rate is limited for the first time
+
+	if (AppliedPresentationRate <= 0.0f)
+	{
+		SavedMaxFPS = CVarMaxFPS ? CVarMaxFPS->GetFloat() : 0.0f;
+		SavedAsyncLoadingTimeLimit = CVarAsyncLoadingTimeLimit ? CVarAsyncLoadingTimeLimit->GetFloat() : 0.0f;
+		SavedAsyncLoadingUseFullTimeLimit = CVarAsyncLoadingUseFullTimeLimit ? CVarAsyncLoadingUseFullTimeLimit->GetInt() : 0;
+
+		MaxFPSSetBy = GetOverrideSetBy(CVarMaxFPS);
+		AsyncLoadingTimeLimitSetBy = GetOverrideSetBy(CVarAsyncLoadingTimeLimit);
+		AsyncLoadingUseFullTimeLimitSetBy = GetOverrideSetBy(CVarAsyncLoadingUseFullTimeLimit);
+	}
+
+	AppliedPresentationRate = Rate;
+	AppliedAsyncLoadingTimeShare = AsyncLoadingTimeShare;
+
+	// Limit the presentation rate
+
+	if (CVarMaxFPS)
+	{
+		CVarMaxFPS->Set(Rate, MaxFPSSetBy);
+	}
+
+	// Give the freed frame time to async loading on the game thread
+
+	const auto AsyncLoadingTimeLimitMs{ (1000.0f / Rate) * AsyncLoadingTimeShare };
+
+	if (CVarAsyncLoadingTimeLimit)
+	{
+		CVarAsyncLoadingTimeLimit->Set(FMath::Max(AsyncLoadingTimeLimitMs, SavedAsyncLoadingTimeLimit), AsyncLoadingTimeLimitSetBy);
+	}
+
+	if (CVarAsyncLoadingUseFullTimeLimit)
+	{
+		CVarAsyncLoadingUseFullTimeLimit->Set(1, AsyncLoadingUseFullTimeLimitSetBy);
+	}
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Presentation rate limited to %.1f Hz (AsyncLoadingTimeLimit: %.1f ms)"), Rate, AsyncLoadingTimeLimitMs);
+}
+
+void FLoadingGlobalStateArbiter::RestorePresentationRate()
+{
+	auto* CVarMaxFPS{ GetMaxFPSCVar() };
+	auto* CVarAsyncLoadingTimeLimit{ GetAsyncLoadingTimeLimitCVar() };
+	auto* CVarAsyncLoadingUseFullTimeLimit{ GetAsyncLoadingUseFullTimeLimitCVar() };
+
+	if (CVarMaxFPS)
+	{
+		CVarMaxFPS->Set(SavedMaxFPS, MaxFPSSetBy);
+	}
+
+	if (CVarAsyncLoadingTimeLimit)
+	{
+		CVarAsyncLoadingTimeLimit->Set(SavedAsyncLoadingTimeLimit, AsyncLoadingTimeLimitSetBy);
+	}
+
+	if (CVarAsyncLoadingUseFullTimeLimit)
+	{
+		CVarAsyncLoadingUseFullTimeLimit->Set(SavedAsyncLoadingUseFullTimeLimit, AsyncLoadingUseFullTimeLimitSetBy);
+	}
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Presentation rate restored"));
+
+	AppliedPresentationRate = 0.0f;
+	AppliedAsyncLoadingTimeShare = 0.0f;
+}
+
+EConsoleVariableFlags FLoadingGlobalStateArbiter::GetOverrideSetBy(const IConsoleVariable* CVar)
+{
+	// Use the priority of the current value if it is higher than code so that the change is not rejected
+
+	const auto SetBy{ CVar ? static_cast<uint32>(CVar->GetFlags() & ECVF_SetByMask) : 0u };
+
+	return static_cast<EConsoleVariableFlags>(FMath::Max<uint32>(SetBy, ECVF_SetByCode));
+}
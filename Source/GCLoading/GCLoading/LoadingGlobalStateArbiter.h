@@ -0,0 +1,190 @@
+﻿// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+
+
+/**
+ * Process-wide states changed by the loading global state arbiter
+ * 
+ * Tip:
+ *	The engine target is used by default. Tests inject their own target so that the states of the running process are not changed.
+ */
+class ILoadingGlobalStateTarget
+{
+public:
+	virtual ~ILoadingGlobalStateTarget() {}
+
+	/**
+	 * Changes the shader batch mode and the hang and hitch detection
+	 */
+	virtual void SetSavingPerformance(bool bSaving) = 0;
+
+	/**
+	 * Registers the input preprocessor and returns whether it was registered
+	 * 
+	 * Tip:
+	 *	Returns false while Slate is not initialized.
+	 */
+	virtual bool RegisterInputPreProcessor() = 0;
+	virtual void UnregisterInputPreProcessor() = 0;
+
+	/**
+	 * Returns the console variable changed to limit the presentation rate
+	 */
+	virtual IConsoleVariable* FindConsoleVariable(const TCHAR* Name) const = 0;
+
+};
+
+
+/**
+ * Process-wide arbiter of the global states changed while loading screens are displayed
+ * 
+ * Tip:
+ *	Multiple game instances in one process (such as multi-client PIE or in-process load tests) share these states.
+ *	Each state is applied while at least one loading screen requests it and restored when the last request is released.
+ * 
+ * !!!Note!!!:
+ *	Must be used from the game thread.
+ */
+class GCLOADING_API FLoadingGlobalStateArbiter
+{
+public:
+	FLoadingGlobalStateArbiter();
+	explicit FLoadingGlobalStateArbiter(ILoadingGlobalStateTarget& InTarget)
+		: Target(InTarget)
+	{}
+
+	~FLoadingGlobalStateArbiter();
+
+	UE_NONCOPYABLE(FLoadingGlobalStateArbiter);
+
+	static FLoadingGlobalStateArbiter& Get();
+
+	/**
+	 * Returns the target that changes the states of the running engine
+	 */
+	static ILoadingGlobalStateTarget& GetEngineTarget();
+
+protected:
+	/**
+	 * Presentation rate requested by a loading screen and the share of its frame time given to async loading
+	 */
+	struct FPresentationRateRequest
+	{
+	public:
+		float Rate{ 0.0f };
+		float AsyncLoadingTimeShare{ 0.0f };
+	};
+
+protected:
+	ILoadingGlobalStateTarget& Target;
+
+	//
+	// Number of loading screens that need to be saved performance
+	//
+	int32 SavingPerformanceRefCount{ 0 };
+
+	//
+	// Number of loading screens that need to be input blocked
+	//
+	int32 InputBlockRefCount{ 0 };
+
+	//
+	// Whether the input preprocessor shared by all loading screens is registered
+	//
+	bool bInputPreProcessorRegistered{ false };
+
+	//
+	// Ticker that retries the registration of the input preprocessor until Slate is initialized
+	//
+	FTSTicker::FDelegateHandle PendingInputPreProcessorHandle;
+
+	//
+	// Mapping list of requesters and the presentation rate they request
+	//
+	TMap<const void*, FPresentationRateRequest> PresentationRateRequests;
+
+	//
+	// Presentation rate currently applied (0 if not limited)
+	//
+	float AppliedPresentationRate{ 0.0f };
+
+	//
+	// Share of the frame time given to async loading by the requester whose rate is applied
+	//
+	float AppliedAsyncLoadingTimeShare{ 0.0f };
+
+	//
+	// Values of the console variables before the presentation rate was limited
+	//
+	float SavedMaxFPS{ 0.0f };
+	float SavedAsyncLoadingTimeLimit{ 0.0f };
+	int32 SavedAsyncLoadingUseFullTimeLimit{ 0 };
+
+	//
+	// Priorities used to change the console variables while the presentation rate is limited
+	// 
+	// Tip:
+	//	A value set with a higher priority than code (such as from the console) is overridden and restored with that priority.
+	//	The engine cannot lower the priority of a console variable, so values set with a lower priority are restored by code.
+	//
+	EConsoleVariableFlags MaxFPSSetBy{ ECVF_SetByCode };
+	EConsoleVariableFlags AsyncLoadingTimeLimitSetBy{ ECVF_SetByCode };
+	EConsoleVariableFlags AsyncLoadingUseFullTimeLimitSetBy{ ECVF_SetByCode };
+
+public:
+	/**
+	 * Changes the shader batch mode and suspends the hang and hitch detection while any loading screen saves performance
+	 */
+	void AcquireSavingPerformance();
+	void ReleaseSavingPerformance();
+
+	/**
+	 * Registers the input preprocessor while any loading screen blocks input
+	 * 
+	 * Tip:
+	 *	If Slate is not initialized yet, the preprocessor is registered on the first tick after it is while input is still blocked.
+	 */
+	void AcquireInputBlock();
+	void ReleaseInputBlock();
+
+	/**
+	 * Requests the presentation rate and the share of its frame time given to async loading.
+	 * The lowest rate among the requesters is applied together with the share requested with it.
+	 * 
+	 * Tip:
+	 *	If Rate is 0 or less, the request of the requester is removed.
+	 */
+	void RequestPresentationRate(const void* Requester, float Rate, float AsyncLoadingTimeShare);
+
+	bool IsSavingPerformance() const { return SavingPerformanceRefCount > 0; }
+	bool IsInputBlocked() const { return InputBlockRefCount > 0; }
+	bool IsInputPreProcessorRegistered() const { return bInputPreProcessorRegistered; }
+	bool IsInputPreProcessorRegistrationPending() const { return PendingInputPreProcessorHandle.IsValid(); }
+
+	/**
+	 * Registers the input preprocessor if input is blocked and it could not be registered yet, and returns whether it is still pending
+	 * 
+	 * Tip:
+	 *	Called by the core ticker while the registration is pending.
+	 */
+	bool UpdatePendingInputPreProcessor();
+	float GetAppliedPresentationRate() const { return AppliedPresentationRate; }
+	float GetAppliedAsyncLoadingTimeShare() const { return AppliedAsyncLoadingTimeShare; }
+
+protected:
+	void CancelPendingInputPreProcessor();
+
+	void ApplyPresentationRate(float Rate, float AsyncLoadingTimeShare);
+	void RestorePresentationRate();
+
+	IConsoleVariable* GetMaxFPSCVar() const { return Target.FindConsoleVariable(TEXT("t.MaxFPS")); }
+	IConsoleVariable* GetAsyncLoadingTimeLimitCVar() const { return Target.FindConsoleVariable(TEXT("s.AsyncLoadingTimeLimit")); }
+	IConsoleVariable* GetAsyncLoadingUseFullTimeLimitCVar() const { return Target.FindConsoleVariable(TEXT("s.AsyncLoadingUseFullTimeLimit")); }
+
+	static EConsoleVariableFlags GetOverrideSetBy(const IConsoleVariable* CVar);
+
+};
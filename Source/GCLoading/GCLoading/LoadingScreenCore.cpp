@@ -0,0 +1,332 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "LoadingScreenCore.h"
+
+
+void FLoadingScreenCore::SetNumTypes(int32 NumTypes)
+{
+	TypeStates.SetNum(NumTypes);
+	ActiveTypes.SetNum(NumTypes, false);
+	PendingAddTypes.SetNum(NumTypes, false);
+	PendingRemoveTypes.SetNum(NumTypes, false);
+	ShownTypes.SetNum(NumTypes, false);
+}
+
+void FLoadingScreenCore::Reset()
+{
+	const auto NumTypes{ TypeStates.Num() };
+
+	TypeStates.Reset();
+	TypeStates.SetNum(NumTypes);
+	ActiveTypes.Init(false, NumTypes);
+	PendingAddTypes.Init(false, NumTypes);
+	PendingRemoveTypes.Init(false, NumTypes);
+	ShownTypes.Init(false, NumTypes);
+
+	InputBlockCount = 0;
+	SavingPerformanceCount = 0;
+	NumSuppressedShows = 0;
+
+	BatchDepth = 0;
+	BatchTypes.Empty();
+}
+
+
+// Processes
+
+void FLoadingScreenCore::AddProcess(int32 TypeIndex, const FLoadingScreenCoreTypeSettings& Settings)
+{
+	auto& State{ TypeStates[TypeIndex] };
+
+	// Added to ongoing loading, which keeps the settings it started with
+
+	if (ActiveTypes[TypeIndex])
+	{
+		State.NumProcesses++;
+
+		CancelPendingRemove(TypeIndex);
+		return;
+	}
+
+	State = FLoadingScreenCoreTypeState();
+	State.Settings = Settings;
+	State.NumProcesses = 1;
+	State.StartTime = Clock.GetLoadingTime();
+
+	ActiveTypes[TypeIndex] = true;
+
+	AddToPendingAdd(TypeIndex);
+}
+
+void FLoadingScreenCore::RemoveProcess(int32 TypeIndex)
+{
+	if (!ActiveTypes[TypeIndex])
+	{
+		return;
+	}
+
+	auto& State{ TypeStates[TypeIndex] };
+	State.NumProcesses = FMath::Max(State.NumProcesses - 1, 0);
+
+	if (State.NumProcesses == 0)
+	{
+		AddToPendingRemove(TypeIndex);
+	}
+}
+
+void FLoadingScreenCore::RemoveType(int32 TypeIndex)
+{
+	if (ActiveTypes[TypeIndex])
+	{
+		AddToPendingRemove(TypeIndex);
+	}
+}
+
+
+void FLoadingScreenCore::AddToPendingAdd(int32 TypeIndex)
+{
+	if (IsBatchOpen())
+	{
+		BatchTypes.FindOrAdd(TypeIndex).bNewType = true;
+		return;
+	}
+
+	PendingAddTypes[TypeIndex] = true;
+
+	CancelPendingRemove(TypeIndex);
+}
+
+void FLoadingScreenCore::AddToPendingRemove(int32 TypeIndex)
+{
+	if (IsBatchOpen())
+	{
+		BatchTypes.FindOrAdd(TypeIndex).bRemoveRequested = true;
+		return;
+	}
+
+	PendingRemoveTypes[TypeIndex] = true;
+	TypeStates[TypeIndex].PendingRemoveStartTime = Clock.GetLoadingTime();
+}
+
+void FLoadingScreenCore::CancelPendingRemove(int32 TypeIndex)
+{
+	if (IsBatchOpen())
+	{
+		BatchTypes.FindOrAdd(TypeIndex).bRemoveRequested = false;
+		return;
+	}
+
+	PendingRemoveTypes[TypeIndex] = false;
+}
+
+void FLoadingScreenCore::DeactivateType(int32 TypeIndex)
+{
+	ActiveTypes[TypeIndex] = false;
+	PendingAddTypes[TypeIndex] = false;
+	PendingRemoveTypes[TypeIndex] = false;
+
+	TypeStates[TypeIndex].NumProcesses = 0;
+}
+
+
+// Batch
+
+bool FLoadingScreenCore::EndBatch()
+{
+	if (BatchDepth <= 0)
+	{
+		return false;
+	}
+
+	BatchDepth--;
+
+	// Apply only when the outermost batch is closed
+
+	if ((BatchDepth > 0) || BatchTypes.IsEmpty())
+	{
+		return false;
+	}
+
+	ApplyBatch();
+
+	return true;
+}
+
+void FLoadingScreenCore::ApplyBatch()
+{
+	// Take the changes out first, since listeners may open a new batch while they are applied
+
+	const auto AppliedTypes{ MoveTemp(BatchTypes) };
+	BatchTypes.Reset();
+
+	// Apply only the net result of the changes for each loading type
+
+	for (const auto& KVP : AppliedTypes)
+	{
+		const auto& TypeIndex{ KVP.Key };
+		const auto& BatchState{ KVP.Value };
+
+		if (!ActiveTypes[TypeIndex])
+		{
+			continue;
+		}
+
+		const auto bShouldRemove{ BatchState.bRemoveRequested || (TypeStates[TypeIndex].NumProcesses == 0) };
+
+		if (BatchState.bNewType)
+		{
+			// Loading types that started and finished within the batch are never displayed
+
+			if (bShouldRemove)
+			{
+				DeactivateType(TypeIndex);
+
+				NumSuppressedShows++;
+
+				Listener.HandleLoadingTypeDiscarded(TypeIndex);
+			}
+			else
+			{
+				AddToPendingAdd(TypeIndex);
+			}
+		}
+		else
+		{
+			if (bShouldRemove)
+			{
+				AddToPendingRemove(TypeIndex);
+			}
+			else
+			{
+				CancelPendingRemove(TypeIndex);
+			}
+		}
+	}
+}
+
+
+// Update
+
+void FLoadingScreenCore::Update()
+{
+	// Process Pending Add
+
+	if (PendingAddTypes.Contains(true))
+	{
+		const auto CurrentTime{ Clock.GetLoadingTime() };
+
+		for (auto TypeIndex{ 0 }; TypeIndex < PendingAddTypes.Num(); ++TypeIndex)
+		{
+			if (PendingAddTypes[TypeIndex] && TryShowType(TypeIndex, CurrentTime))
+			{
+				PendingAddTypes[TypeIndex] = false;
+			}
+		}
+	}
+
+	// Process Pending Remove
+
+	if (PendingRemoveTypes.Contains(true))
+	{
+		const auto CurrentTime{ Clock.GetLoadingTime() };
+
+		TArray<FLoadingScreenCoreFinishedType, TInlineAllocator<2>> FinishedTypes;
+
+		for (auto TypeIndex{ 0 }; TypeIndex < PendingRemoveTypes.Num(); ++TypeIndex)
+		{
+			if (PendingRemoveTypes[TypeIndex] && TryHideType(TypeIndex, CurrentTime))
+			{
+				FinishedTypes.Emplace(TypeIndex, TypeStates[TypeIndex].PendingRemoveStartTime);
+
+				DeactivateType(TypeIndex);
+			}
+		}
+
+		// Notify after the iteration so that listeners can safely add new loading processes
+
+		if (!FinishedTypes.IsEmpty())
+		{
+			Listener.HandleLoadingTypesFinished(FinishedTypes);
+		}
+	}
+}
+
+bool FLoadingScreenCore::TryShowType(int32 TypeIndex, double CurrentTime)
+{
+	auto& State{ TypeStates[TypeIndex] };
+
+	// Loading that already ended within the show delay is never displayed, even if the update came late
+
+	if (PendingRemoveTypes[TypeIndex] && ((State.PendingRemoveStartTime - State.StartTime) < State.Settings.ShowDelaySecs))
+	{
+		return false;
+	}
+
+	// Wait for the show delay so that short loading is never displayed
+
+	if (((CurrentTime - State.StartTime) < State.Settings.ShowDelaySecs) && !Listener.CanShowLoadingTypeImmediately(TypeIndex))
+	{
+		return false;
+	}
+
+	ShownTypes[TypeIndex] = true;
+	State.ShownStartTime = CurrentTime;
+
+	if (State.Settings.bBlockInputs && (InputBlockCount++ == 0))
+	{
+		Listener.HandleInputBlockChanged(true);
+	}
+
+	if (State.Settings.bSavingPerformance && (SavingPerformanceCount++ == 0))
+	{
+		Listener.HandleSavingPerformanceChanged(true);
+	}
+
+	Listener.HandleLoadingTypeShown(TypeIndex);
+
+	return true;
+}
+
+bool FLoadingScreenCore::TryHideType(int32 TypeIndex, double CurrentTime)
+{
+	const auto& State{ TypeStates[TypeIndex] };
+
+	// Loading ended within the show delay, so the loading type is never displayed
+
+	if (!ShownTypes[TypeIndex])
+	{
+		PendingAddTypes[TypeIndex] = false;
+
+		NumSuppressedShows++;
+
+		Listener.HandleLoadingTypeSuppressed(TypeIndex);
+
+		return true;
+	}
+
+	// Keep displaying for additional seconds after loading ends and for the minimum visible time
+
+	const auto HoldSecs{ bHoldAdditionalSecs ? State.Settings.AdditionalSecs : 0.0f };
+	const auto HideTime{ FMath::Max(State.PendingRemoveStartTime + HoldSecs, State.ShownStartTime + State.Settings.MinVisibleSecs) };
+
+	if (HideTime > CurrentTime)
+	{
+		return false;
+	}
+
+	ShownTypes[TypeIndex] = false;
+
+	if (State.Settings.bBlockInputs && (--InputBlockCount == 0))
+	{
+		Listener.HandleInputBlockChanged(false);
+	}
+
+	if (State.Settings.bSavingPerformance && (--SavingPerformanceCount == 0))
+	{
+		Listener.HandleSavingPerformanceChanged(false);
+	}
+
+	Listener.HandleLoadingTypeHidden(TypeIndex);
+
+	return true;
+}
@@ -0,0 +1,352 @@
+﻿// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/ArrayView.h"
+#include "Containers/BitArray.h"
+#include "Containers/Map.h"
+
+
+/**
+ * Clock injected into the loading screen core
+ */
+class ILoadingScreenCoreClock
+{
+public:
+	virtual ~ILoadingScreenCoreClock() {}
+
+	/**
+	 * Returns the current time in seconds used for loading
+	 */
+	virtual double GetLoadingTime() const = 0;
+
+};
+
+
+/**
+ * Loading type whose loading has finished in the update of the loading screen core
+ */
+struct FLoadingScreenCoreFinishedType
+{
+public:
+	FLoadingScreenCoreFinishedType() {}
+
+	FLoadingScreenCoreFinishedType(int32 InTypeIndex, double InEndTime)
+		: TypeIndex(InTypeIndex), EndTime(InEndTime)
+	{}
+
+public:
+	//
+	// Index of the loading type
+	//
+	int32 TypeIndex{ INDEX_NONE };
+
+	//
+	// Time when the removal of the loading type was requested
+	//
+	double EndTime{ 0.0 };
+
+};
+
+
+/**
+ * Receiver of the side effects decided by the loading screen core
+ */
+class ILoadingScreenCoreListener
+{
+public:
+	virtual ~ILoadingScreenCoreListener() {}
+
+	/**
+	 * Returns whether the loading type can be displayed without waiting for its show delay
+	 */
+	virtual bool CanShowLoadingTypeImmediately(int32 TypeIndex) const { return false; }
+
+	virtual void HandleLoadingTypeShown(int32 TypeIndex) {}
+	virtual void HandleLoadingTypeHidden(int32 TypeIndex) {}
+
+	/**
+	 * Notifies that the loading of the type ended within its show delay and was never displayed
+	 */
+	virtual void HandleLoadingTypeSuppressed(int32 TypeIndex) {}
+
+	/**
+	 * Notifies the loading types whose loading has finished and that are no longer active
+	 * 
+	 * Tip:
+	 *	All of them are notified at once after the update, so that listeners can safely add new loading processes.
+	 */
+	virtual void HandleLoadingTypesFinished(TConstArrayView<FLoadingScreenCoreFinishedType> FinishedTypes) {}
+
+	/**
+	 * Notifies that the loading type started and finished within a batch and was never processed
+	 * 
+	 * Tip:
+	 *	It is counted as a suppressed show, since its loading ended before it could be displayed.
+	 */
+	virtual void HandleLoadingTypeDiscarded(int32 TypeIndex) {}
+
+	virtual void HandleInputBlockChanged(bool bBlocked) {}
+	virtual void HandleSavingPerformanceChanged(bool bSaving) {}
+
+};
+
+
+/**
+ * Settings of the loading type captured when its loading starts
+ */
+struct FLoadingScreenCoreTypeSettings
+{
+public:
+	FLoadingScreenCoreTypeSettings() {}
+
+public:
+	//
+	// Number of seconds to wait after loading starts before displaying
+	//
+	float ShowDelaySecs{ 0.0f };
+
+	//
+	// Number of seconds to continue displaying after loading ends
+	//
+	float AdditionalSecs{ 0.0f };
+
+	//
+	// Minimum number of seconds to keep displaying once displayed
+	//
+	float MinVisibleSecs{ 0.0f };
+
+	//
+	// Whether input is blocked while displayed
+	//
+	bool bBlockInputs{ false };
+
+	//
+	// Whether the game saves performance while displayed
+	//
+	bool bSavingPerformance{ false };
+
+};
+
+
+/**
+ * State of the loading type tracked by the loading screen core
+ */
+struct FLoadingScreenCoreTypeState
+{
+public:
+	FLoadingScreenCoreTypeState() {}
+
+public:
+	//
+	// Settings captured when the loading started
+	//
+	FLoadingScreenCoreTypeSettings Settings;
+
+	//
+	// Number of ongoing loading processes
+	//
+	int32 NumProcesses{ 0 };
+
+	//
+	// Time when the first loading process was added
+	//
+	double StartTime{ 0.0 };
+
+	//
+	// Time when the removal was requested
+	//
+	double PendingRemoveStartTime{ 0.0 };
+
+	//
+	// Time when the loading type was displayed
+	//
+	double ShownStartTime{ 0.0 };
+
+};
+
+
+/**
+ * Changes made to a loading type while a loading process batch is open
+ */
+struct FLoadingProcessBatchTagState
+{
+public:
+	FLoadingProcessBatchTagState() {}
+
+public:
+	//
+	// Whether the loading type information was newly created in the batch
+	//
+	bool bNewType{ false };
+
+	//
+	// Whether the removal of the whole loading type was requested in the batch
+	//
+	bool bRemoveRequested{ false };
+
+};
+
+
+/**
+ * State machine of the loading types that decides when they are displayed and hidden
+ * 
+ * Tip:
+ *	It covers the process counts, the pending add/remove, the show delay and hold timers and the input and performance reference counts.
+ *	It does not depend on UObject, Slate or the platform clock, so the time and every side effect are injected.
+ * 
+ * !!!Note!!!:
+ *	The clock and the listener must outlive the core.
+ */
+class GCLOADING_API FLoadingScreenCore
+{
+public:
+	FLoadingScreenCore(const ILoadingScreenCoreClock& InClock, ILoadingScreenCoreListener& InListener)
+		: Clock(InClock), Listener(InListener)
+	{}
+
+	UE_NONCOPYABLE(FLoadingScreenCore);
+
+protected:
+	const ILoadingScreenCoreClock& Clock;
+	ILoadingScreenCoreListener& Listener;
+
+	//
+	// List of states of the loading types, indexed by loading type index
+	//
+	TArray<FLoadingScreenCoreTypeState> TypeStates;
+
+	//
+	// Bits of the loading types that currently have ongoing loading
+	//
+	TBitArray<> ActiveTypes;
+
+	//
+	// Bits of the loading types that are started and need to be displayed
+	//
+	TBitArray<> PendingAddTypes;
+
+	//
+	// Bits of the loading types that are finished and need to be hidden
+	//
+	TBitArray<> PendingRemoveTypes;
+
+	//
+	// Bits of the loading types that are actually displayed
+	//
+	TBitArray<> ShownTypes;
+
+	//
+	// Number of displayed loading types that block input
+	//
+	int32 InputBlockCount{ 0 };
+
+	//
+	// Number of displayed loading types that save performance
+	//
+	int32 SavingPerformanceCount{ 0 };
+
+	//
+	// Number of loading types that were never displayed because the loading ended within their show delay
+	//
+	int32 NumSuppressedShows{ 0 };
+
+	//
+	// Nesting depth of the currently open loading process batches
+	//
+	int32 BatchDepth{ 0 };
+
+	//
+	// Mapping list of loading type indices changed while the batch is open and their changes
+	//
+	TMap<int32, FLoadingProcessBatchTagState> BatchTypes;
+
+	//
+	// Whether the loading type is held for additional seconds after loading is complete
+	//
+	bool bHoldAdditionalSecs{ true };
+
+public:
+	/**
+	 * Resizes the state to the number of loading types, keeping the state of existing indices
+	 */
+	void SetNumTypes(int32 NumTypes);
+
+	void SetHoldAdditionalSecs(bool bHold) { bHoldAdditionalSecs = bHold; }
+
+	/**
+	 * Clears all state without notifying the listener
+	 */
+	void Reset();
+
+	////////////////////////////////////////////////////////
+	// Processes
+public:
+	/**
+	 * Adds a loading process to the loading type, starting its loading with the settings if it is not active
+	 */
+	void AddProcess(int32 TypeIndex, const FLoadingScreenCoreTypeSettings& Settings);
+
+	/**
+	 * Removes a loading process from the loading type, requesting its removal when none remain
+	 */
+	void RemoveProcess(int32 TypeIndex);
+
+	/**
+	 * Requests the removal of the loading type regardless of its remaining processes
+	 */
+	void RemoveType(int32 TypeIndex);
+
+protected:
+	void AddToPendingAdd(int32 TypeIndex);
+	void AddToPendingRemove(int32 TypeIndex);
+	void CancelPendingRemove(int32 TypeIndex);
+	void DeactivateType(int32 TypeIndex);
+
+	////////////////////////////////////////////////////////
+	// Batch
+public:
+	void BeginBatch() { BatchDepth++; }
+
+	/**
+	 * Closes the batch and returns whether the outermost batch applied any change
+	 */
+	bool EndBatch();
+
+	bool IsBatchOpen() const { return BatchDepth > 0; }
+
+protected:
+	void ApplyBatch();
+
+	////////////////////////////////////////////////////////
+	// Update
+public:
+	/**
+	 * Displays the pending loading types whose show delay has passed and hides the finished ones whose hold time has passed
+	 */
+	void Update();
+
+protected:
+	bool TryShowType(int32 TypeIndex, double CurrentTime);
+	bool TryHideType(int32 TypeIndex, double CurrentTime);
+
+	////////////////////////////////////////////////////////
+	// Queries
+public:
+	int32 GetNumTypes() const { return TypeStates.Num(); }
+
+	bool IsTypeActive(int32 TypeIndex) const { return ActiveTypes[TypeIndex]; }
+	bool IsTypePendingRemove(int32 TypeIndex) const { return PendingRemoveTypes[TypeIndex]; }
+	bool IsTypeShown(int32 TypeIndex) const { return ShownTypes[TypeIndex]; }
+	bool HasShownType() const { return ShownTypes.Contains(true); }
+	const TBitArray<>& GetShownTypes() const { return ShownTypes; }
+
+	int32 GetNumProcesses(int32 TypeIndex) const { return TypeStates[TypeIndex].NumProcesses; }
+
+	bool IsInputBlocked() const { return InputBlockCount > 0; }
+	bool IsSavingPerformance() const { return SavingPerformanceCount > 0; }
+
+	int32 GetNumSuppressedShows() const { return NumSuppressedShows; }
+
+};
@@ -4,25 +4,179 @@
 
 #include "LoadingDeveloperSettings.h"
 #include "Observer/LoadingObserver.h"
+#include "LoadingGlobalStateArbiter.h"
 #include "GCLoadingLogs.h"
+#include "GCLoadingStats.h"
 
 #include "Blueprint/UserWidget.h"
+#include "Engine/Engine.h"
 #include "Engine/GameInstance.h"
 #include "Engine/GameViewportClient.h"
-#include "ShaderPipelineCache.h"
-#include "HAL/ThreadHeartBeat.h"
+#include "Engine/PendingNetGame.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
 #include "PreLoadScreen.h"
 #include "PreLoadScreenManager.h"
-#include "Framework/Application/IInputProcessor.h"
 #include "Framework/Application/SlateApplication.h"
+#include "Widgets/SInvalidationPanel.h"
+#include "Slate/SRetainerWidget.h"
+#include "Misc/StringBuilder.h"
+#include "Misc/PackageName.h"
+#include "Misc/App.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "RenderingThread.h"
+#include "RenderTargetPool.h"
+#include "Algo/Count.h"
+#include "UObject/UObjectGlobals.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LoadingScreenSubsystem)
 
 
+static FAutoConsoleCommandWithWorld GCLoadingMemoryReportCommand(
+	TEXT("GCLoading.MemoryReport"),
+	TEXT("Prints the memory usage recorded at show, peak and hide for recent loading screen transitions"),
+	FConsoleCommandWithWorldDelegate::CreateLambda(
+		[](UWorld* World)
+		{
+			const auto* GameInstance{ World ? World->GetGameInstance() : nullptr };
+			const auto* Subsystem{ GameInstance ? GameInstance->GetSubsystem<ULoadingScreenSubsystem>() : nullptr };
+
+			if (Subsystem)
+			{
+				UE_LOG(LogGameCore_LoadingScreen, Display, TEXT("%s"), *Subsystem->GetMemoryReport());
+			}
+		}
+	)
+);
+
+static ULoadingScreenSubsystem* FindLoadingScreenSubsystem(UWorld* World)
+{
+	auto* GameInstance{ World ? World->GetGameInstance() : nullptr };
+	return GameInstance ? GameInstance->GetSubsystem<ULoadingScreenSubsystem>() : nullptr;
+}
+
+static FAutoConsoleCommandWithWorld GCLoadingStartRecordingCommand(
+	TEXT("GCLoading.Record.Start"),
+	TEXT("Starts recording loading process changes, observer decisions and loading widget show/hide"),
+	FConsoleCommandWithWorldDelegate::CreateLambda(
+		[](UWorld* World)
+		{
+			if (auto* Subsystem{ FindLoadingScreenSubsystem(World) })
+			{
+				Subsystem->StartEventRecording();
+			}
+		}
+	)
+);
+
+static FAutoConsoleCommandWithWorldAndArgs GCLoadingStopRecordingCommand(
+	TEXT("GCLoading.Record.Stop"),
+	TEXT("Stops recording loading events and saves them under Saved/Loading/Recordings. Usage: GCLoading.Record.Stop [Name]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda(
+		[](const TArray<FString>& Args, UWorld* World)
+		{
+			if (auto* Subsystem{ FindLoadingScreenSubsystem(World) })
+			{
+				Subsystem->StopEventRecording(FLoadingEventRecorder::GetFilePath(Args.IsValidIndex(0) ? Args[0] : FString(TEXT("LoadingEvents"))));
+			}
+		}
+	)
+);
+
+static FAutoConsoleCommandWithWorldAndArgs GCLoadingReplayCommand(
+	TEXT("GCLoading.Replay"),
+	TEXT("Replays recorded loading events in headless mode and compares the visibility decisions. Usage: GCLoading.Replay [Name] [Speed]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda(
+		[](const TArray<FString>& Args, UWorld* World)
+		{
+			if (auto* Subsystem{ FindLoadingScreenSubsystem(World) })
+			{
+				const auto FilePath{ FLoadingEventRecorder::GetFilePath(Args.IsValidIndex(0) ? Args[0] : FString(TEXT("LoadingEvents"))) };
+				const auto Speed{ Args.IsValidIndex(1) ? FCString::Atof(*Args[1]) : 1.0f };
+
+				Subsystem->StartEventReplay(FilePath, Speed);
+			}
+		}
+	)
+);
+
+static FAutoConsoleCommandWithWorld GCLoadingStopReplayCommand(
+	TEXT("GCLoading.Replay.Stop"),
+	TEXT("Stops replaying loading events"),
+	FConsoleCommandWithWorldDelegate::CreateLambda(
+		[](UWorld* World)
+		{
+			if (auto* Subsystem{ FindLoadingScreenSubsystem(World) })
+			{
+				Subsystem->StopEventReplay();
+			}
+		}
+	)
+);
+
+
+// FLoadingScreenShowingWidget
+
+void FLoadingScreenShowingWidget::UpdateCollapsed(bool bWasCollapsed)
+{
+	const auto bCollapsed{ IsCollapsed() };
+
+	if ((bCollapsed == bWasCollapsed) || !SlateWidget.IsValid())
+	{
+		return;
+	}
+
+	if (bCollapsed)
+	{
+		VisibilityBeforeCollapse = SlateWidget->GetVisibility();
+		SlateWidget->SetVisibility(EVisibility::Collapsed);
+		SlateWidget->SetCanTick(false);
+	}
+	else
+	{
+		SlateWidget->SetVisibility(VisibilityBeforeCollapse);
+		SlateWidget->SetCanTick(true);
+	}
+}
+
+
 // Initialization
 
 void ULoadingScreenSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
+	bHeadless = ShouldUseHeadlessMode();
+
+	if (bHeadless)
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Loading screen is running in headless mode"));
+	}
+
+	RebuildLoadingTypeTable();
+
+	InitializeLoadingHistory();
+
+	HitchDetector.Initialize();
+
+	if (FPlatformProcess::SupportsMultithreading())
+	{
+		WatchdogThread.Start(WatchdogCheckIntervalSecs);
+	}
+
+#if WITH_EDITOR
+	GetMutableDefault<ULoadingDeveloperSettings>()->OnSettingChanged().AddUObject(this, &ThisClass::HandleDeveloperSettingsChanged);
+#endif
+
+	FWorldDelegates::OnSeamlessTravelStart.AddUObject(this, &ThisClass::HandleSeamlessTravelStart);
+	GetGameInstance()->OnNotifyPreClientTravel().AddUObject(this, &ThisClass::HandlePreClientTravel);
+	FNetDelegates::OnPendingNetGameConnectionCreated.AddUObject(this, &ThisClass::HandlePendingNetGameConnectionCreated);
+	FCoreUObjectDelegates::PreLoadMapWithContext.AddUObject(this, &ThisClass::HandlePreLoadMapForPrefetch);
+	FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &ThisClass::HandlePostGarbageCollectForPrefetch);
+	FCoreDelegates::OnEndFrame.AddUObject(this, &ThisClass::HandleEndFrameForMemoryTrim);
+
+	PrefetchPredictedLoadingWidgets();
+
 	InitializeObservers();
 }
 
@@ -30,16 +184,67 @@ void ULoadingScreenSubsystem::Deinitialize()
 {
 	DeinitializeObservers();
 
+	DeinitializeLoadingHistory();
+
+	FWorldDelegates::OnSeamlessTravelStart.RemoveAll(this);
+	GetGameInstance()->OnNotifyPreClientTravel().RemoveAll(this);
+	FNetDelegates::OnPendingNetGameConnectionCreated.RemoveAll(this);
+	FCoreUObjectDelegates::PreLoadMapWithContext.RemoveAll(this);
+	FCoreUObjectDelegates::GetPostGarbageCollect().RemoveAll(this);
+	FCoreDelegates::OnEndFrame.RemoveAll(this);
+
+	bPendingWidgetClassRePrefetch = false;
+
+	for (auto& Handle : WidgetClassPrefetchHandles)
+	{
+		if (Handle.IsValid())
+		{
+			Handle->CancelHandle();
+			Handle.Reset();
+		}
+	}
+
+	HitchDetector.WriteReport();
+	HitchDetector.Reset();
+
+	MemoryTracker.Reset();
+
+	WatchdogThread.Shutdown();
+	WatchdogThreadDeadline = 0.0;
+
+	WatchdogReportedProcesses.Empty();
+	WatchdogReportedTypes.Init(false, LoadingTypeTable.Num());
+
+	if (EventRecorder.IsRecording())
+	{
+		StopEventRecording(FLoadingEventRecorder::GetFilePath(TEXT("LoadingEvents")));
+	}
+
+	EventRecorder.Reset();
+	ReplayEvents.Empty();
+	bReplayingEvents = false;
+
+#if WITH_EDITOR
+	GetMutableDefault<ULoadingDeveloperSettings>()->OnSettingChanged().RemoveAll(this);
+#endif
+
 	LoadingWidgetOverrides.Empty();
 	LoadingScreenInfos.Empty();
-	PendingAddLoadingTags.Empty();
-	PendingRemoveLoadingTags.Empty();
+	Core.Reset();
+
+	// Open batches are discarded with the core state
+
+	LoadingProcessBatchEpoch++;
+
+	LoadingProcessChangedDelegates.Empty();
+	OnLoadingProcessChanged.Clear();
 
 	bLoadingWidgetDisplayed = false;
 
-	ClearInputBlockCount();
-	ClearSavingPerformanceCount();
+	UpdateInputBlock();
+	UpdatePerformance();
 	RemoveAllWidgets();
+	RestorePresentationRate();
 }
 
 bool ULoadingScreenSubsystem::ShouldCreateSubsystem(UObject* Outer) const
@@ -53,16 +258,87 @@ bool ULoadingScreenSubsystem::ShouldCreateSubsystem(UObject* Outer) const
 }
 
 
+// Headless
+
+bool ULoadingScreenSubsystem::ShouldUseHeadlessMode() const
+{
+	if (FParse::Param(FCommandLine::Get(), TEXT("LoadingScreenHeadless")))
+	{
+		return true;
+	}
+
+	return GetDefault<ULoadingDeveloperSettings>()->bUseHeadlessModeWhenCannotRender && !FApp::CanEverRender();
+}
+
+
 // Tick
 
 void ULoadingScreenSubsystem::Tick(float DeltaTime)
 {
-	TickObservers(DeltaTime);
+	const auto TickStartCycles{ FPlatformTime::Cycles64() };
+
+	// Recorded events replace the decisions of the loading observers while replaying
+
+	if (bReplayingEvents)
+	{
+		TickEventReplay();
+	}
+	else
+	{
+		TickObservers(DeltaTime);
+	}
+
+	if (bLoadingWidgetDisplayed)
+	{
+		MemoryTracker.Sample();
+
+		if (LoadingScreenHitchThresholdSecs > 0.0f)
+		{
+			SampleLoadingScreenFrame(FApp::GetDeltaTime());
+		}
+	}
+
+	if (!LoadingScreenInfos.IsEmpty())
+	{
+		TickWatchdog(GetLoadingTime());
+	}
+	else if (WatchdogThreadDeadline > 0.0)
+	{
+		UpdateWatchdogThreadDeadline(0.0, 0.0, FString());
+	}
 
 	if (!IsShowingInitialLoadingScreen())
 	{
 		UpdateLoadingWidgets();
 	}
+
+	// Publish the ongoing loading so that perf captures can attribute frame time to it
+
+#if STATS || CSV_PROFILER
+	auto NumActiveProcesses{ 0 };
+
+	for (const auto& KVP : LoadingScreenInfos)
+	{
+		NumActiveProcesses += KVP.Value.Processes.Num();
+	}
+
+	SET_DWORD_STAT(STAT_GCLoading_ActiveProcesses, NumActiveProcesses);
+	SET_DWORD_STAT(STAT_GCLoading_ActiveLoadingTypes, LoadingScreenInfos.Num());
+
+	CSV_CUSTOM_STAT(GCLoading, ActiveProcesses, NumActiveProcesses, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(GCLoading, ActiveLoadingTypes, LoadingScreenInfos.Num(), ECsvCustomStatOp::Set);
+#endif
+
+	if (bReplayingEvents)
+	{
+		ReplayResult.OverheadCycles += FPlatformTime::Cycles64() - TickStartCycles;
+		ReplayResult.NumFrames++;
+
+		if (IsEventReplayComplete())
+		{
+			FinishEventReplay();
+		}
+	}
 }
 
 ETickableTickType ULoadingScreenSubsystem::GetTickableTickType() const
@@ -77,7 +353,7 @@ bool ULoadingScreenSubsystem::IsTickable() const
 
 TStatId ULoadingScreenSubsystem::GetStatId() const
 {
-	RETURN_QUICK_DECLARE_CYCLE_STAT(ULoadingScreenSubsystem, STATGROUP_Tickables);
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULoadingScreenSubsystem, STATGROUP_GCLoading);
 }
 
 UWorld* ULoadingScreenSubsystem::GetTickableGameObjectWorld() const
@@ -121,13 +397,23 @@ void ULoadingScreenSubsystem::DeinitializeObservers()
 
 void ULoadingScreenSubsystem::TickObservers(float DeltaTime)
 {
+	SCOPE_CYCLE_COUNTER(STAT_GCLoading_TickObservers);
+
+	// Only dispatch to observers that are due according to their tick policy
+
+	TArray<ULoadingObserver*, TInlineAllocator<8>> DueObservers;
+
 	for (const auto& Observer : ActiveObservers)
 	{
-		if (Observer)
+		if (Observer && Observer->UpdateTickDue(DeltaTime, bLoadingWidgetDisplayed))
 		{
-			Observer->Tick(DeltaTime);
+			DueObservers.Add(Observer);
 		}
 	}
+
+	TGuardValue<bool> DispatchingObserversGuard(bDispatchingObservers, true);
+
+	ULoadingObserver::DispatchObservers(DueObservers, bEvaluateObserversInParallel);
 }
 
 
@@ -147,87 +433,225 @@ void ULoadingScreenSubsystem::AddLoadingWidgetOverride(FGameplayTag LoadingTypeT
 		return;
 	}
 
-	LoadingWidgetOverrides.Emplace(LoadingTypeTag, WidgetClass);
+	LoadingWidgetOverrides.Emplace(LoadingTypeTag, TSoftClassPtr<UUserWidget>(WidgetClass.Get()));
+
+	RebuildLoadingTypeTable();
 }
 
 
-// Loading Processes Infos
+// Loading Type Table
 
-bool ULoadingScreenSubsystem::AddLoadingProcess(FName ProcessName, FGameplayTag LoadingTypeTag, FText Reason)
+void ULoadingScreenSubsystem::RebuildLoadingTypeTable()
 {
-	if (!LoadingTypeTag.IsValid())
+	const auto* DevSettings{ GetDefault<ULoadingDeveloperSettings>() };
+
+	if (!DevSettings)
 	{
-		UE_LOG(LogGameCore_LoadingScreen, Error, TEXT("An invalid loading type tag attempted to add a loading process."));
-		return false;
+		UE_LOG(LogGameCore_LoadingScreen, Fatal, TEXT("DevSettings is invalid"));
+		return;
 	}
 
-	if (Reason.IsEmpty())
+	// Existing entries keep their indices so that ongoing loading processes stay valid
+
+	for (auto& Entry : LoadingTypeTable)
 	{
-		UE_LOG(LogGameCore_LoadingScreen, Error, TEXT("Loading reason not set."));
-		return false;
+		Entry.bDefined = false;
+		Entry.OverrideWidgetClass.Reset();
 	}
 
-	if (!ProcessName.IsValid() || ProcessName.IsNone())
+	for (const auto& KVP : DevSettings->LoadingScreenDefinitions)
 	{
-		UE_LOG(LogGameCore_LoadingScreen, Error, TEXT("Process Name not set."));
-		return false;
-	}
+		if (!KVP.Key.IsValid())
+		{
+			continue;
+		}
 
-	// If there is already information for the same loading type, add it there
+		auto TypeIndex{ FindLoadingTypeIndex(KVP.Key) };
 
-	if (auto* FoundInfo{ LoadingScreenInfos.Find(LoadingTypeTag) })
+		if (TypeIndex == INDEX_NONE)
+		{
+			TypeIndex = LoadingTypeTable.AddDefaulted();
+			LoadingTypeIndices.Emplace(KVP.Key, TypeIndex);
+		}
+
+		auto& Entry{ LoadingTypeTable[TypeIndex] };
+		Entry.LoadingTypeTag = KVP.Key;
+		Entry.Definition = KVP.Value;
+		Entry.bDefined = true;
+	}
+
+	for (const auto& KVP : LoadingWidgetOverrides)
 	{
-		return AddLoadingProcessExistType(*FoundInfo, ProcessName, LoadingTypeTag, Reason);
+		const auto TypeIndex{ FindLoadingTypeIndex(KVP.Key) };
+
+		if (TypeIndex != INDEX_NONE)
+		{
+			LoadingTypeTable[TypeIndex].OverrideWidgetClass = KVP.Value;
+		}
 	}
 
-	// If the same loading type information is not already available, create a new one based on DevSettings
+	// Resize state to match the table
+
+	const auto NumTypes{ LoadingTypeTable.Num() };
+
+	Core.SetNumTypes(NumTypes);
+	WidgetClassPrefetchHandles.SetNum(NumTypes);
+	WatchdogReportedTypes.SetNum(NumTypes, false);
+
+	// Cache flags read while updating the loading widgets
+
+	bForceTickLoadingScreen = !bHeadless && (!GIsEditor || DevSettings->bForceTickLoadingScreenInEditor);
+	Core.SetHoldAdditionalSecs(!GIsEditor || DevSettings->bShouldHoldLoadingScreenAdditionalSecsInEditor);
+	LoadingScreenHitchThresholdSecs = DevSettings->bDetectLoadingScreenHitches ? (DevSettings->LoadingScreenHitchThresholdMs / 1000.0f) : 0.0f;
+	LoadingProcessTimeoutSecs = DevSettings->LoadingProcessTimeoutSecs;
+	bEvaluateObserversInParallel = DevSettings->bEvaluateObserversInParallel;
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Rebuilt loading type table (Num Types: %d)"), NumTypes);
+}
+
+int32 ULoadingScreenSubsystem::FindLoadingTypeIndex(const FGameplayTag& LoadingTypeTag) const
+{
+	const auto* FoundIndex{ LoadingTypeIndices.Find(LoadingTypeTag) };
+	return FoundIndex ? *FoundIndex : INDEX_NONE;
+}
+
+#if WITH_EDITOR
+void ULoadingScreenSubsystem::HandleDeveloperSettingsChanged(UObject* Settings, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	RebuildLoadingTypeTable();
+}
+#endif
+
+bool ULoadingScreenSubsystem::IsLoadingTypeActive(FGameplayTag LoadingTypeTag) const
+{
+	const auto TypeIndex{ FindLoadingTypeIndex(LoadingTypeTag) };
+	return (TypeIndex != INDEX_NONE) && Core.IsTypeActive(TypeIndex);
+}
+
 
+// Memory Trim
+
+void ULoadingScreenSubsystem::TrimMemoryForTransition()
+{
 	const auto* DevSettings{ GetDefault<ULoadingDeveloperSettings>() };
 
-	if (!DevSettings)
+	if (!DevSettings->bTrimMemoryOnFullscreenLoading)
 	{
-		UE_LOG(LogGameCore_LoadingScreen, Fatal, TEXT("DevSettings is invalid"));
-		return false;
+		return;
 	}
 
-	const auto* Definition{ DevSettings->LoadingScreenDefinitions.Find(LoadingTypeTag) };
+	static constexpr auto BytesToMB{ 1.0 / (1024.0 * 1024.0) };
 
-	if (!Definition)
+	const auto TrimStartTime{ FPlatformTime::Seconds() };
+	const auto TrimStartBytes{ FLoadingMemoryTracker::GetUsedMemory() };
+
+	auto RunStep
 	{
-		UE_LOG(LogGameCore_LoadingScreen, Error, TEXT("Undefined LoadingTypeTag(%s), set from DeveloperSettings."), *LoadingTypeTag.GetTagName().ToString());
-		return false;
+		[](const TCHAR* StepName, TFunctionRef<void()> Step)
+		{
+			const auto StartTime{ FPlatformTime::Seconds() };
+			const auto StartBytes{ static_cast<int64>(FLoadingMemoryTracker::GetUsedMemory()) };
+
+			Step();
+
+			const auto FreedBytes{ StartBytes - static_cast<int64>(FLoadingMemoryTracker::GetUsedMemory()) };
+
+			UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Memory trim step %s (Freed: %.1fMB, Time: %.2fms)"),
+				StepName, FreedBytes * BytesToMB, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+		}
+	};
+
+	// Purge first, since purged objects release their render resources
+
+	if (DevSettings->bTrimPurgeUnreferencedObjects)
+	{
+		RunStep(TEXT("PurgeUnreferencedObjects"), []() { CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true); });
+
+		bPendingGarbageCollectionRequest = false;
+	}
+
+	if (DevSettings->bTrimFlushRenderResources)
+	{
+		RunStep(TEXT("FlushRenderResources"), []() { FlushRenderingCommands(); });
+	}
+
+	if (DevSettings->bTrimPooledRenderTargets)
+	{
+		RunStep(TEXT("PooledRenderTargets"),
+			[]()
+			{
+				ENQUEUE_RENDER_COMMAND(GCLoadingFreeUnusedRenderTargets)(
+					[](FRHICommandListImmediate& RHICmdList)
+					{
+						GRenderTargetPool.FreeUnusedResources();
+					});
+
+				FlushRenderingCommands();
+			});
+	}
+
+	if (DevSettings->bTrimAllocator)
+	{
+		RunStep(TEXT("Allocator"), []() { GMalloc->Trim(true); });
 	}
 
-	return AddLoadingProcessNew(ProcessName, LoadingTypeTag, Reason, *Definition);
+	const auto TotalFreedBytes{ static_cast<int64>(TrimStartBytes) - static_cast<int64>(FLoadingMemoryTracker::GetUsedMemory()) };
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Memory trimmed for transition (Freed: %.1fMB, Time: %.2fms)"),
+		TotalFreedBytes * BytesToMB, (FPlatformTime::Seconds() - TrimStartTime) * 1000.0);
 }
 
-bool ULoadingScreenSubsystem::RemoveLoadingProcess(FName ProcessName)
+void ULoadingScreenSubsystem::HandleEndFrameForMemoryTrim()
 {
-	// Iterate LoadingScreenInfos
-
-	for (auto& KVP : LoadingScreenInfos)
+	if ((!bPendingMemoryTrim && !bPendingGarbageCollectionRequest) || (GFrameCounter < MemoryTrimReadyFrame))
 	{
-		// Search for Info containing handles
+		return;
+	}
 
-		auto& Tag{ KVP.Key };
-		auto& Info{ KVP.Value };
-		auto& ProcessNameReasonMap{ Info.Processes };
+	// Skip while replaying so that the measured overhead only contains the work of this subsystem
+
+	const auto bCanStall{ !bReplayingEvents && IsOpaqueLoadingScreenDisplayed() };
+
+	if (bPendingMemoryTrim)
+	{
+		bPendingMemoryTrim = false;
 
-		if (ProcessNameReasonMap.Contains(ProcessName))
+		if (bCanStall)
 		{
-			UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Remove Loading process (ProcessName: %s)"), *ProcessName.ToString());
+			TrimMemoryForTransition();
+		}
+	}
 
-			// Remove handle items from HandleReasonMap
+	// Run the requested garbage collection while the player cannot see the pause
 
-			ProcessNameReasonMap.Remove(ProcessName);
+	if (bPendingGarbageCollectionRequest && bCanStall)
+	{
+		RunRequestedGarbageCollection();
+	}
+}
 
-			// If a valid handle no longer exists at this point, it is added to PendingRemove
+void ULoadingScreenSubsystem::RunRequestedGarbageCollection()
+{
+	bPendingGarbageCollectionRequest = false;
 
-			if (ProcessNameReasonMap.IsEmpty())
-			{
-				AddTagToPendingRemoveList(Tag);
-			}
+	const auto StartTime{ FPlatformTime::Seconds() };
 
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Requested garbage collection ran during loading screen (Time: %.2fms)"), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void ULoadingScreenSubsystem::RequestGarbageCollectionDuringLoadingScreen()
+{
+	bPendingGarbageCollectionRequest = true;
+}
+
+bool ULoadingScreenSubsystem::IsOpaqueLoadingScreenDisplayed() const
+{
+	for (TConstSetBitIterator<> It(Core.GetShownTypes()); It; ++It)
+	{
+		if (LoadingTypeTable[It.GetIndex()].Definition.bOpaqueFullscreen)
+		{
 			return true;
 		}
 	}
@@ -235,262 +659,1475 @@ bool ULoadingScreenSubsystem::RemoveLoadingProcess(FName ProcessName)
 	return false;
 }
 
-bool ULoadingScreenSubsystem::RemoveLoadingProcessByTag(FGameplayTag LoadingTypeTag)
+
+// Widget Class Residency
+
+TSoftClassPtr<UUserWidget> ULoadingScreenSubsystem::GetLoadingWidgetClassPath(int32 TypeIndex) const
+{
+	const auto& Entry{ LoadingTypeTable[TypeIndex] };
+
+	return Entry.OverrideWidgetClass.IsNull() ? TSoftClassPtr<UUserWidget>(Entry.Definition.WidgetClass) : Entry.OverrideWidgetClass;
+}
+
+TSubclassOf<UUserWidget> ULoadingScreenSubsystem::ResolveLoadingWidgetClass(int32 TypeIndex)
 {
-	if (LoadingScreenInfos.Contains(LoadingTypeTag))
+	auto& Entry{ LoadingTypeTable[TypeIndex] };
+	const auto ClassPath{ GetLoadingWidgetClassPath(TypeIndex) };
+
+	// Use the resident class if it is still the one to display
+
+	if (Entry.ResidentWidgetClass && (Entry.ResidentWidgetClass.Get() == ClassPath.Get()))
 	{
-		AddTagToPendingRemoveList(LoadingTypeTag);
-		return true;
+		return Entry.ResidentWidgetClass;
 	}
 
-	return false;
-}
+	TSubclassOf<UUserWidget> WidgetClass{ ClassPath.Get() };
 
+	if (!WidgetClass)
+	{
+		// Load synchronously if it has not been prefetched in time
 
-bool ULoadingScreenSubsystem::AddLoadingProcessExistType(FLoadingScreenInfo& Info, FName ProcessName, const FGameplayTag& LoadingTypeTag, const FText& Reason)
+		UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Load widget class synchronously (Class: %s)"), *ClassPath.ToString());
+
+		WidgetClass = ClassPath.LoadSynchronous();
+	}
+
+	if (Entry.Definition.ResidencyPolicy == ELoadingWidgetResidencyPolicy::AlwaysResident)
+	{
+		Entry.ResidentWidgetClass = WidgetClass;
+	}
+
+	return WidgetClass;
+}
+
+void ULoadingScreenSubsystem::ReleaseLoadingWidgetClass(int32 TypeIndex)
 {
-	// Early out if Process Name already exist
+	auto& Entry{ LoadingTypeTable[TypeIndex] };
 
-	if (Info.Processes.Contains(ProcessName))
+	if (Entry.Definition.ResidencyPolicy == ELoadingWidgetResidencyPolicy::AlwaysResident)
 	{
-		return false;
+		return;
+	}
+
+	// Only the weak reference remains, so GC can reclaim the class and the assets it references
+
+	if (Entry.ResidentWidgetClass)
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Release widget class (Class: %s)"), *GetNameSafe(Entry.ResidentWidgetClass));
 	}
 
-	Info.Processes.Add(ProcessName, Reason);
+	Entry.ResidentWidgetClass = nullptr;
+
+	if (WidgetClassPrefetchHandles[TypeIndex].IsValid())
+	{
+		WidgetClassPrefetchHandles[TypeIndex]->ReleaseHandle();
+		WidgetClassPrefetchHandles[TypeIndex].Reset();
+	}
+
+	// Loading it again right away would keep the class alive, so wait until GC has reclaimed it
+
+	if (Entry.Definition.ResidencyPolicy == ELoadingWidgetResidencyPolicy::PreloadBeforeUse)
+	{
+		if (!bPendingWidgetClassRePrefetch)
+		{
+			WidgetClassReleaseBytes = FLoadingMemoryTracker::GetUsedMemory();
+		}
+
+		bPendingWidgetClassRePrefetch = true;
+	}
+}
+
+void ULoadingScreenSubsystem::PrefetchLoadingWidgetClass(int32 TypeIndex)
+{
+	auto& Entry{ LoadingTypeTable[TypeIndex] };
+	const auto ClassPath{ GetLoadingWidgetClassPath(TypeIndex) };
+
+	if (bHeadless || ClassPath.IsNull() || Entry.ResidentWidgetClass || WidgetClassPrefetchHandles[TypeIndex].IsValid())
+	{
+		return;
+	}
+
+	// Keep the class that is still in memory instead of loading it again
+
+	if (auto* LoadedClass{ ClassPath.Get() })
+	{
+		Entry.ResidentWidgetClass = LoadedClass;
+		return;
+	}
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Prefetch widget class (Class: %s)"), *ClassPath.ToString());
+
+	WidgetClassPrefetchHandles[TypeIndex] = WidgetClassStreamableManager.RequestAsyncLoad(
+		ClassPath.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &ThisClass::HandleLoadingWidgetClassPrefetched, TypeIndex));
+}
+
+void ULoadingScreenSubsystem::HandleLoadingWidgetClassPrefetched(int32 TypeIndex)
+{
+	if (LoadingTypeTable.IsValidIndex(TypeIndex))
+	{
+		auto& Entry{ LoadingTypeTable[TypeIndex] };
+
+		Entry.ResidentWidgetClass = GetLoadingWidgetClassPath(TypeIndex).Get();
+	}
+}
+
+void ULoadingScreenSubsystem::HandleSeamlessTravelStart(UWorld* World, const FString& LevelName)
+{
+	if (World && (World->GetGameInstance() == GetGameInstance()))
+	{
+		PrefetchPredictedLoadingWidgets();
+	}
+}
+
+void ULoadingScreenSubsystem::HandlePreClientTravel(const FString& PendingURL, ETravelType TravelType, bool bIsSeamlessTravel)
+{
+	// Called before the travel is processed, so the prefetch has time to finish before the loading screen is shown
+
+	PrefetchPredictedLoadingWidgets();
+}
+
+void ULoadingScreenSubsystem::HandlePendingNetGameConnectionCreated(UPendingNetGame* PendingNetGame)
+{
+	const auto* WorldContext{ GEngine ? GEngine->GetWorldContextFromPendingNetGame(PendingNetGame) : nullptr };
+
+	if (WorldContext && (WorldContext->OwningGameInstance == GetGameInstance()))
+	{
+		PrefetchPredictedLoadingWidgets();
+	}
+}
+
+void ULoadingScreenSubsystem::HandlePreLoadMapForPrefetch(const FWorldContext& WorldContext, const FString& MapName)
+{
+	// LoadMap flushes async loading before it blocks, so the prefetch completes with the map instead of on the next show
+
+	if (WorldContext.OwningGameInstance == GetGameInstance())
+	{
+		PrefetchPredictedLoadingWidgets();
+	}
+}
+
+void ULoadingScreenSubsystem::HandlePostGarbageCollectForPrefetch()
+{
+	if (!bPendingWidgetClassRePrefetch)
+	{
+		return;
+	}
+
+	bPendingWidgetClassRePrefetch = false;
+
+	const auto FreedBytes{ static_cast<int64>(WidgetClassReleaseBytes) - static_cast<int64>(FLoadingMemoryTracker::GetUsedMemory()) };
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Released widget classes reclaimed by garbage collection (Freed: %.1fMB)"), FreedBytes / (1024.0 * 1024.0));
+
+	PrefetchPredictedLoadingWidgets();
+}
+
+void ULoadingScreenSubsystem::PrefetchLoadingWidget(FGameplayTag LoadingTypeTag)
+{
+	const auto TypeIndex{ FindLoadingTypeIndex(LoadingTypeTag) };
+
+	if (TypeIndex == INDEX_NONE)
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Error, TEXT("Undefined LoadingTypeTag(%s), set from DeveloperSettings."), *LoadingTypeTag.GetTagName().ToString());
+		return;
+	}
+
+	PrefetchLoadingWidgetClass(TypeIndex);
+}
+
+void ULoadingScreenSubsystem::PrefetchPredictedLoadingWidgets()
+{
+	for (auto TypeIndex{ 0 }; TypeIndex < LoadingTypeTable.Num(); ++TypeIndex)
+	{
+		const auto& Entry{ LoadingTypeTable[TypeIndex] };
+
+		if (Entry.bDefined && (Entry.Definition.ResidencyPolicy == ELoadingWidgetResidencyPolicy::PreloadBeforeUse))
+		{
+			PrefetchLoadingWidgetClass(TypeIndex);
+		}
+	}
+}
+
+
+// Loading Processes Infos
+
+bool ULoadingScreenSubsystem::AddLoadingProcess(FName ProcessName, FGameplayTag LoadingTypeTag, FText Reason)
+{
+	if (!LoadingTypeTag.IsValid())
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Error, TEXT("An invalid loading type tag attempted to add a loading process."));
+		return false;
+	}
+
+	if (Reason.IsEmpty())
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Error, TEXT("Loading reason not set."));
+		return false;
+	}
+
+	if (!ProcessName.IsValid() || ProcessName.IsNone())
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Error, TEXT("Process Name not set."));
+		return false;
+	}
+
+	if (ShouldIgnoreLiveLoadingInput(ProcessName))
+	{
+		return false;
+	}
+
+	RecordLoadingEvent(ELoadingRecordedEventType::ProcessAdded, LoadingTypeTag.GetTagName(), ProcessName, Reason);
+
+	// If there is already information for the same loading type, add it there
+
+	if (auto* FoundInfo{ LoadingScreenInfos.Find(LoadingTypeTag) })
+	{
+		return AddLoadingProcessExistType(*FoundInfo, ProcessName, LoadingTypeTag, Reason);
+	}
+
+	// If the same loading type information is not already available, create a new one based on the loading type table
+
+	const auto TypeIndex{ FindLoadingTypeIndex(LoadingTypeTag) };
+
+	if ((TypeIndex == INDEX_NONE) || !LoadingTypeTable[TypeIndex].bDefined)
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Error, TEXT("Undefined LoadingTypeTag(%s), set from DeveloperSettings."), *LoadingTypeTag.GetTagName().ToString());
+		return false;
+	}
+
+	return AddLoadingProcessNew(ProcessName, LoadingTypeTag, Reason, TypeIndex);
+}
+
+bool ULoadingScreenSubsystem::RemoveLoadingProcess(FName ProcessName)
+{
+	if (ShouldIgnoreLiveLoadingInput(ProcessName))
+	{
+		return false;
+	}
+
+	// Iterate LoadingScreenInfos
+
+	for (auto& KVP : LoadingScreenInfos)
+	{
+		// Search for Info containing handles
+
+		const auto Tag{ KVP.Key };
+		auto& Info{ KVP.Value };
+
+		if (const auto* Entry{ Info.FindProcess(ProcessName) })
+		{
+			UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Remove Loading process (ProcessName: %s)"), *WriteToString<64>(ProcessName));
+
+			RecordLoadingEvent(ELoadingRecordedEventType::ProcessRemoved, Tag.GetTagName(), ProcessName);
+
+			const auto Duration{ GetLoadingTime() - Entry->StartTime };
+
+			Info.RemoveProcess(ProcessName);
+
+			// If a valid handle no longer exists at this point, the core adds it to PendingRemove
+
+			Core.RemoveProcess(Info.TypeIndex);
+
+			// Notify last, since listeners may change LoadingScreenInfos
+
+			RecordLoadingHistory(Tag, ProcessName, Duration);
+			NotifyLoadingProcessChanged(Tag, ProcessName, ELoadingProcessChangeType::Removed);
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool ULoadingScreenSubsystem::RemoveLoadingProcessByTag(FGameplayTag LoadingTypeTag)
+{
+	if (ShouldIgnoreLiveLoadingInput(NAME_None))
+	{
+		return false;
+	}
+
+	if (const auto* Info{ LoadingScreenInfos.Find(LoadingTypeTag) })
+	{
+		RecordLoadingEvent(ELoadingRecordedEventType::TypeRemoved, LoadingTypeTag.GetTagName());
+
+		Core.RemoveType(Info->TypeIndex);
+		return true;
+	}
+
+	return false;
+}
+
+
+bool ULoadingScreenSubsystem::AddLoadingProcessExistType(FLoadingScreenInfo& Info, FName ProcessName, const FGameplayTag& LoadingTypeTag, const FText& Reason)
+{
+	// Early out if Process Name already exist
+
+	if (Info.ContainsProcess(ProcessName))
+	{
+		return false;
+	}
+
+	auto& NewEntry{ Info.AddProcess(ProcessName, Reason, GetLoadingTime()) };
+	NewEntry.ExpectedDuration = GetExpectedDuration(LoadingTypeTag, ProcessName);
+
+	Core.AddProcess(Info.TypeIndex, MakeCoreTypeSettings(LoadingTypeTable[Info.TypeIndex].Definition));
+
+	NotifyLoadingProcessChanged(LoadingTypeTag, ProcessName, ELoadingProcessChangeType::Added);
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Add Loading process Exist type (Reason: %s, Handle: %s)"), *Reason.ToString(), *WriteToString<64>(ProcessName));
+
+	return true;
+}
+
+bool ULoadingScreenSubsystem::AddLoadingProcessNew(FName ProcessName, const FGameplayTag& LoadingTypeTag, const FText& Reason, int32 TypeIndex)
+{
+	const auto& Entry{ LoadingTypeTable[TypeIndex] };
+	const auto& Def{ Entry.Definition };
+
+	// Select Widget class, which is never loaded in headless mode
+
+	auto WidgetClass{ bHeadless ? TSubclassOf<UUserWidget>() : ResolveLoadingWidgetClass(TypeIndex) };
+	check(bHeadless || WidgetClass);
+
+	// Build Loading process info in place to avoid copying it into the list
+
+	const auto CurrentTime{ GetLoadingTime() };
+
+	auto& NewInfo{ LoadingScreenInfos.Add(LoadingTypeTag) };
+	NewInfo.StartTime = CurrentTime;
+	NewInfo.ExpectedDuration = GetExpectedDuration(LoadingTypeTag, NAME_None);
+
+	auto& NewEntry{ NewInfo.AddProcess(ProcessName, Reason, CurrentTime) };
+	NewEntry.ExpectedDuration = GetExpectedDuration(LoadingTypeTag, ProcessName);
+	NewInfo.WidgetClass = MoveTemp(WidgetClass);
+	NewInfo.ZOrder = Def.ZOrder;
+	NewInfo.AdditionalSec = Def.AdditionalSecs;
+	NewInfo.bBlockInputs = Def.bBlockInputs;
+	NewInfo.bSavingPerfomance = Def.bSavingPerfomance;
+	NewInfo.TypeIndex = TypeIndex;
+
+	Core.AddProcess(TypeIndex, MakeCoreTypeSettings(Def));
+
+	NotifyLoadingProcessChanged(LoadingTypeTag, ProcessName, ELoadingProcessChangeType::Added);
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Add Loading process new (Reason: %s, Handle: %s)"), *Reason.ToString(), *WriteToString<64>(ProcessName));
+
+	return true;
+}
+
+
+const FText& ULoadingScreenSubsystem::GetLoadingReasonFromName(FName ProcessName) const
+{
+	// Iterate LoadingScreenInfos
+
+	for (auto& KVP : LoadingScreenInfos)
+	{
+		// Search for Info containing handles
+
+		auto& Info{ KVP.Value };
+
+		if (auto* Reason{ Info.FindReason(ProcessName) })
+		{
+			return *Reason;
+		}
+	}
+
+	return FText::GetEmpty();
+}
+
+TArray<FText> ULoadingScreenSubsystem::GetLoadingReasonsFromTag(FGameplayTag LoadingTypeTag) const
+{
+	TArray<FText> Reasons;
+
+	if (auto* Info{ LoadingScreenInfos.Find(LoadingTypeTag) })
+	{
+		Reasons.Reserve(Info->Processes.Num());
+
+		for (const auto& Entry : Info->Processes)
+		{
+			Reasons.Emplace(Entry.Reason);
+		}
+	}
+
+	return Reasons;
+}
+
+TArray<FLoadingProcessEntry> ULoadingScreenSubsystem::GetLoadingProcessesFromTag(FGameplayTag LoadingTypeTag) const
+{
+	TArray<FLoadingProcessEntry> Processes;
+
+	if (auto* Info{ LoadingScreenInfos.Find(LoadingTypeTag) })
+	{
+		Processes.Append(Info->Processes);
+	}
+
+	return Processes;
+}
+
+void ULoadingScreenSubsystem::ForEachLoadingReason(const FGameplayTag& LoadingTypeTag, TFunctionRef<void(FName, const FText&)> Func) const
+{
+	if (auto* Info{ LoadingScreenInfos.Find(LoadingTypeTag) })
+	{
+		for (const auto& Entry : Info->Processes)
+		{
+			Func(Entry.ProcessName, Entry.Reason);
+		}
+	}
+}
+
+bool ULoadingScreenSubsystem::SetLoadingProcessReason(FName ProcessName, FText NewReason)
+{
+	if (NewReason.IsEmpty())
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Error, TEXT("Loading reason not set."));
+		return false;
+	}
+
+	if (ShouldIgnoreLiveLoadingInput(ProcessName))
+	{
+		return false;
+	}
+
+	// Iterate LoadingScreenInfos
+
+	for (auto& KVP : LoadingScreenInfos)
+	{
+		const auto Tag{ KVP.Key };
+		auto& Info{ KVP.Value };
+
+		if (auto* Reason{ Info.FindReason(ProcessName) })
+		{
+			// Skip notification if nothing changed
+
+			if (Reason->IdenticalTo(NewReason) || Reason->EqualTo(NewReason))
+			{
+				return true;
+			}
+
+			*Reason = MoveTemp(NewReason);
+
+			RecordLoadingEvent(ELoadingRecordedEventType::ReasonChanged, Tag.GetTagName(), ProcessName, *Reason);
+
+			NotifyLoadingProcessChanged(Tag, ProcessName, ELoadingProcessChangeType::ReasonChanged);
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+// Loading Process Notification
+
+void ULoadingScreenSubsystem::NotifyLoadingProcessChanged(const FGameplayTag& LoadingTypeTag, FName ProcessName, ELoadingProcessChangeType ChangeType)
+{
+	// Replayed loading is not real, so listeners must not react to it
+
+	if (bReplayingEvents)
+	{
+		return;
+	}
+
+	if (auto* Delegate{ LoadingProcessChangedDelegates.Find(LoadingTypeTag) })
+	{
+		Delegate->Broadcast(LoadingTypeTag, ProcessName, ChangeType);
+	}
+
+	OnLoadingProcessChanged.Broadcast(LoadingTypeTag, ProcessName, ChangeType);
+}
+
+void ULoadingScreenSubsystem::NotifyAllLoadingProcessesRemoved(const FGameplayTag& LoadingTypeTag, const FLoadingScreenInfo& Info)
+{
+	for (const auto& Entry : Info.Processes)
+	{
+		NotifyLoadingProcessChanged(LoadingTypeTag, Entry.ProcessName, ELoadingProcessChangeType::Removed);
+	}
+}
+
+
+// Loading Process Batch
+
+void ULoadingScreenSubsystem::BeginLoadingProcessBatch()
+{
+	if (ShouldIgnoreLiveLoadingInput(NAME_None))
+	{
+		return;
+	}
+
+	RecordLoadingEvent(ELoadingRecordedEventType::BatchBegin, NAME_None);
+
+	Core.BeginBatch();
+}
+
+void ULoadingScreenSubsystem::EndLoadingProcessBatch()
+{
+	if (ShouldIgnoreLiveLoadingInput(NAME_None))
+	{
+		return;
+	}
+
+	if (!Core.IsBatchOpen())
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Error, TEXT("EndLoadingProcessBatch() was called without BeginLoadingProcessBatch()"));
+		return;
+	}
+
+	RecordLoadingEvent(ELoadingRecordedEventType::BatchEnd, NAME_None);
+
+	// Evaluate the loading widgets only once for the entire batch
+
+	if (Core.EndBatch() && !IsShowingInitialLoadingScreen())
+	{
+		UpdateLoadingWidgets();
+	}
+}
+
+
+// Loading History
+
+void ULoadingScreenSubsystem::InitializeLoadingHistory()
+{
+	if (GetDefault<ULoadingDeveloperSettings>()->bEnableLoadingHistory)
+	{
+		LoadingHistory.Load(GetLoadingHistoryFilePath());
+	}
+
+	if (auto* World{ GetGameInstance()->GetWorld() })
+	{
+		LoadingHistoryMapName = FName(UWorld::RemovePIEPrefix(World->GetMapName()));
+	}
+
+	FCoreUObjectDelegates::PreLoadMapWithContext.AddUObject(this, &ThisClass::HandlePreLoadMapForHistory);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &ThisClass::HandlePostLoadMapForHistory);
+}
+
+void ULoadingScreenSubsystem::DeinitializeLoadingHistory()
+{
+	FCoreUObjectDelegates::PreLoadMapWithContext.RemoveAll(this);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
+
+	if (LoadingHistory.IsDirty())
+	{
+		LoadingHistory.Save(GetLoadingHistoryFilePath());
+	}
+
+	LoadingHistory.Reset();
+}
+
+FString ULoadingScreenSubsystem::GetLoadingHistoryFilePath() const
+{
+	const auto* WorldContext{ GetGameInstance()->GetWorldContext() };
+
+	return FLoadingHistoryDatabase::GetDefaultFilePath(WorldContext ? WorldContext->PIEInstance : INDEX_NONE);
+}
+
+void ULoadingScreenSubsystem::HandlePreLoadMapForHistory(const FWorldContext& WorldContext, const FString& MapName)
+{
+	if (WorldContext.OwningGameInstance == GetGameInstance())
+	{
+		LoadingHistoryMapName = FName(UWorld::RemovePIEPrefix(FPackageName::GetShortName(MapName)));
+
+		// Map loads block the game thread, so memory is also sampled around them
+
+		MemoryTracker.Sample();
+
+		// Estimates made before the destination was known are refreshed
+
+		RefreshExpectedDurations();
+	}
+}
+
+void ULoadingScreenSubsystem::HandlePostLoadMapForHistory(UWorld* World)
+{
+	if (World && (World->GetGameInstance() == GetGameInstance()))
+	{
+		LoadingHistoryMapName = FName(UWorld::RemovePIEPrefix(World->GetMapName()));
+
+		MemoryTracker.Sample();
+	}
+}
+
+void ULoadingScreenSubsystem::RecordLoadingHistory(const FGameplayTag& LoadingTypeTag, FName ProcessName, float Duration)
+{
+	const auto* DevSettings{ GetDefault<ULoadingDeveloperSettings>() };
+
+	// Replayed loading is not real, so it must not affect the history
+
+	if (!DevSettings->bEnableLoadingHistory || bReplayingEvents)
+	{
+		return;
+	}
+
+	const auto Key{ FLoadingHistoryKey(LoadingHistoryMapName, LoadingTypeTag.GetTagName(), ProcessName) };
+
+	// Compare with the history before recording this duration
+
+	const auto* Samples{ LoadingHistory.FindSamples(Key) };
+	const auto bCanCheckRegression{ Samples && (Samples->Num() >= DevSettings->LoadingHistoryMinSamplesForRegression) };
+	const auto HistoricalP95{ bCanCheckRegression ? Samples->GetPercentile(0.95f) : 0.0f };
+
+	LoadingHistory.RecordDuration(Key, Duration, DevSettings->LoadingHistoryMaxSamples);
+
+	if (bCanCheckRegression && (Duration > HistoricalP95))
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Loading took longer than its history (Map: %s, Tag: %s, Process: %s, Duration: %.2fs, P95: %.2fs)"),
+			*LoadingHistoryMapName.ToString(), *LoadingTypeTag.GetTagName().ToString(), *ProcessName.ToString(), Duration, HistoricalP95);
+
+		OnLoadingSlowerThanHistory.Broadcast(LoadingTypeTag, LoadingHistoryMapName, ProcessName, Duration, HistoricalP95);
+	}
+}
+
+float ULoadingScreenSubsystem::GetExpectedDuration(const FGameplayTag& LoadingTypeTag, FName ProcessName) const
+{
+	const auto* Samples{ LoadingHistory.FindSamples(FLoadingHistoryKey(LoadingHistoryMapName, LoadingTypeTag.GetTagName(), ProcessName)) };
+
+	return (Samples && (Samples->Num() > 0)) ? Samples->GetMedian() : -1.0f;
+}
+
+void ULoadingScreenSubsystem::RefreshExpectedDurations()
+{
+	for (auto& KVP : LoadingScreenInfos)
+	{
+		const auto& Tag{ KVP.Key };
+		auto& Info{ KVP.Value };
+
+		Info.ExpectedDuration = GetExpectedDuration(Tag, NAME_None);
+
+		for (auto& Entry : Info.Processes)
+		{
+			Entry.ExpectedDuration = GetExpectedDuration(Tag, Entry.ProcessName);
+		}
+	}
+}
+
+float ULoadingScreenSubsystem::GetEstimatedLoadingTimeRemaining(FGameplayTag LoadingTypeTag) const
+{
+	const auto* Info{ LoadingScreenInfos.Find(LoadingTypeTag) };
+
+	if (!Info)
+	{
+		return 0.0f;
+	}
+
+	if (Info->ExpectedDuration < 0.0f)
+	{
+		return -1.0f;
+	}
+
+	const auto Elapsed{ static_cast<float>(GetLoadingTime() - Info->StartTime) };
+
+	return FMath::Max(Info->ExpectedDuration - Elapsed, 0.0f);
+}
+
+float ULoadingScreenSubsystem::GetEstimatedProcessTimeRemaining(FName ProcessName) const
+{
+	for (const auto& KVP : LoadingScreenInfos)
+	{
+		if (const auto* Entry{ KVP.Value.FindProcess(ProcessName) })
+		{
+			if (Entry->ExpectedDuration < 0.0f)
+			{
+				return -1.0f;
+			}
+
+			const auto Elapsed{ static_cast<float>(GetLoadingTime() - Entry->StartTime) };
+
+			return FMath::Max(Entry->ExpectedDuration - Elapsed, 0.0f);
+		}
+	}
+
+	return 0.0f;
+}
+
+float ULoadingScreenSubsystem::GetEstimatedLoadingProgress(FGameplayTag LoadingTypeTag) const
+{
+	const auto* Info{ LoadingScreenInfos.Find(LoadingTypeTag) };
+
+	if (!Info)
+	{
+		return 1.0f;
+	}
+
+	if (Info->ExpectedDuration <= 0.0f)
+	{
+		return -1.0f;
+	}
+
+	const auto Elapsed{ static_cast<float>(GetLoadingTime() - Info->StartTime) };
+
+	return FMath::Clamp(Elapsed / Info->ExpectedDuration, 0.0f, 1.0f);
+}
+
+
+// Hitch Detection
+
+void ULoadingScreenSubsystem::SampleLoadingScreenFrame(float FrameSecs)
+{
+	if (!HitchDetector.SampleFrame(FrameSecs, LoadingScreenHitchThresholdSecs))
+	{
+		return;
+	}
+
+	// Attribute the hitch to the loading processes active during the frame
+
+	FLoadingScreenHitch Hitch;
+	Hitch.Time = FDateTime::Now();
+	Hitch.FrameMs = FrameSecs * 1000.0f;
+
+	for (const auto& KVP : LoadingScreenInfos)
+	{
+		Hitch.LoadingTypeTags.Add(KVP.Key);
+
+		for (const auto& Entry : KVP.Value.Processes)
+		{
+			Hitch.ProcessNames.Add(Entry.ProcessName);
+		}
+	}
+
+	HitchDetector.AddHitch(MoveTemp(Hitch));
+}
+
+
+// Memory Tracking
+
+FString ULoadingScreenSubsystem::GetMemoryReport() const
+{
+	auto Report{ MemoryTracker.BuildReport() };
+
+	// List widget classes kept in memory, so that the memory reclaimed by releasing them can be compared
+
+	Report += TEXT("Resident widget classes\n");
+
+	for (const auto& Entry : LoadingTypeTable)
+	{
+		if (Entry.ResidentWidgetClass)
+		{
+			Report += FString::Printf(TEXT("%s,%s,%s\n"),
+				*Entry.LoadingTypeTag.ToString(), *GetNameSafe(Entry.ResidentWidgetClass), *UEnum::GetValueAsString(Entry.Definition.ResidencyPolicy));
+		}
+	}
+
+	return Report;
+}
+
+
+// Watchdog
+
+void ULoadingScreenSubsystem::TickWatchdog(double CurrentTime)
+{
+	if (CurrentTime < NextWatchdogCheckTime)
+	{
+		return;
+	}
+
+	NextWatchdogCheckTime = CurrentTime + WatchdogCheckIntervalSecs;
+
+	// Find loading processes and loading types that exceed their timeout
+
+	TSet<FName> StalledProcesses;
+	TArray<FName, TInlineAllocator<4>> NewStalledProcesses;
+	TArray<FGameplayTag, TInlineAllocator<2>> NewStalledTypes;
+
+	auto NextDeadline{ 0.0 };
+	FName NextDeadlineProcess{ NAME_None };
+	FGameplayTag NextDeadlineType;
+
+	auto AddDeadline
+	{
+		[&NextDeadline, &NextDeadlineProcess, &NextDeadlineType](double Deadline, FName ProcessName, const FGameplayTag& Tag)
+		{
+			if ((NextDeadline <= 0.0) || (Deadline < NextDeadline))
+			{
+				NextDeadline = Deadline;
+				NextDeadlineProcess = ProcessName;
+				NextDeadlineType = Tag;
+			}
+		}
+	};
+
+	for (const auto& KVP : LoadingScreenInfos)
+	{
+		const auto& Info{ KVP.Value };
+		const auto& TypeIndex{ Info.TypeIndex };
+
+		// Loading types that are already finished and waiting to be hidden are not stalled
+
+		if (Core.IsTypePendingRemove(TypeIndex))
+		{
+			WatchdogReportedTypes[TypeIndex] = false;
+			continue;
+		}
+
+		if (LoadingProcessTimeoutSecs > 0.0f)
+		{
+			for (const auto& Entry : Info.Processes)
+			{
+				if ((CurrentTime - Entry.StartTime) >= LoadingProcessTimeoutSecs)
+				{
+					StalledProcesses.Add(Entry.ProcessName);
+
+					if (!WatchdogReportedProcesses.Contains(Entry.ProcessName))
+					{
+						NewStalledProcesses.Add(Entry.ProcessName);
+					}
+				}
+				else
+				{
+					AddDeadline(Entry.StartTime + LoadingProcessTimeoutSecs, Entry.ProcessName, FGameplayTag());
+				}
+			}
+		}
+
+		const auto& TimeoutSecs{ LoadingTypeTable[TypeIndex].Definition.TimeoutSecs };
+		const auto bTypeStalled{ (TimeoutSecs > 0.0f) && ((CurrentTime - Info.StartTime) >= TimeoutSecs) };
+
+		if (bTypeStalled && !WatchdogReportedTypes[TypeIndex])
+		{
+			NewStalledTypes.Add(KVP.Key);
+		}
+		else if ((TimeoutSecs > 0.0f) && !bTypeStalled)
+		{
+			AddDeadline(Info.StartTime + TimeoutSecs, NAME_None, KVP.Key);
+		}
+
+		WatchdogReportedTypes[TypeIndex] = bTypeStalled;
+	}
+
+	// Processes that are no longer stalled can be reported again
+
+	WatchdogReportedProcesses = MoveTemp(StalledProcesses);
+
+	if (NextDeadline != WatchdogThreadDeadline)
+	{
+		const auto NextCause{ NextDeadlineType.IsValid()
+			? FString::Printf(TEXT("Type(%s)"), *NextDeadlineType.GetTagName().ToString())
+			: FString::Printf(TEXT("Process(%s)"), *WriteToString<64>(NextDeadlineProcess)) };
+
+		UpdateWatchdogThreadDeadline(NextDeadline, CurrentTime, NextCause);
+	}
+
+	if (NewStalledProcesses.IsEmpty() && NewStalledTypes.IsEmpty())
+	{
+		return;
+	}
+
+	// Report stalled loading
+
+	TStringBuilder<256> Cause;
+
+	for (const auto& ProcessName : NewStalledProcesses)
+	{
+		Cause.Appendf(TEXT("%sProcess(%s)"), (Cause.Len() > 0) ? TEXT(", ") : TEXT(""), *WriteToString<64>(ProcessName));
+	}
+
+	for (const auto& Tag : NewStalledTypes)
+	{
+		Cause.Appendf(TEXT("%sType(%s)"), (Cause.Len() > 0) ? TEXT(", ") : TEXT(""), *Tag.GetTagName().ToString());
+	}
+
+	// The game thread call stack is dumped by WatchdogThread, since this check cannot run while the game thread is blocked
+
+	DumpStalledLoadingReport(Cause.ToString());
+
+	// Remove stalled loading so that the loading screen does not stay forever
+
+	if (GetDefault<ULoadingDeveloperSettings>()->bForceRemoveTimedOutLoadingProcesses)
+	{
+		for (const auto& ProcessName : NewStalledProcesses)
+		{
+			UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Force remove stalled loading process (Handle: %s)"), *WriteToString<64>(ProcessName));
+
+			RemoveLoadingProcess(ProcessName);
+		}
+
+		for (const auto& Tag : NewStalledTypes)
+		{
+			UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Force remove stalled loading type (Tag: %s)"), *Tag.GetTagName().ToString());
+
+			RemoveLoadingProcessByTag(Tag);
+		}
+	}
+}
+
+void ULoadingScreenSubsystem::UpdateWatchdogThreadDeadline(double Deadline, double CurrentTime, const FString& Cause)
+{
+	WatchdogThreadDeadline = Deadline;
+
+	// Replayed loading runs on a scaled clock and is not checked by the thread
+
+	if ((Deadline <= 0.0) || bReplayingEvents)
+	{
+		WatchdogThread.SetDeadline(0.0, FString());
+		return;
+	}
+
+	WatchdogThread.SetDeadline(FPlatformTime::Seconds() + (Deadline - CurrentTime), Cause);
+}
+
+void ULoadingScreenSubsystem::DumpStalledLoadingReport(const FString& Cause) const
+{
+	const auto CurrentTime{ GetLoadingTime() };
+
+	UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Loading watchdog timed out: %s"), *Cause);
+	UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("  Async loading: %s (Pending Packages: %d)"), IsAsyncLoading() ? TEXT("TRUE") : TEXT("FALSE"), GetNumAsyncPackages());
+
+	for (const auto& KVP : LoadingScreenInfos)
+	{
+		const auto& Info{ KVP.Value };
+
+		UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("  [%s] Age: %.1fs, Processes: %d"), *KVP.Key.GetTagName().ToString(), CurrentTime - Info.StartTime, Info.Processes.Num());
+
+		for (const auto& Entry : Info.Processes)
+		{
+			UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("    - %s Age: %.1fs, Reason: %s"), *WriteToString<64>(Entry.ProcessName), CurrentTime - Entry.StartTime, *Entry.Reason.ToString());
+		}
+	}
+}
+
+
+// Event Recording
+
+void ULoadingScreenSubsystem::RecordLoadingEvent(ELoadingRecordedEventType Type, FName LoadingTypeName, FName ProcessName, const FText& Reason, bool bVisible)
+{
+	if (EventRecorder.IsRecording())
+	{
+		EventRecorder.Record(Type, GetLoadingTime(), LoadingTypeName, ProcessName, Reason.ToString(), bDispatchingObservers, bVisible);
+	}
+}
+
+bool ULoadingScreenSubsystem::StartEventRecording()
+{
+	if (bReplayingEvents)
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Error, TEXT("Loading events cannot be recorded while replaying"));
+		return false;
+	}
+
+	EventRecorder.BeginRecording(GetLoadingTime());
+
+	// Record the ongoing loading as added at the start
+
+	for (const auto& KVP : LoadingScreenInfos)
+	{
+		for (const auto& Entry : KVP.Value.Processes)
+		{
+			RecordLoadingEvent(ELoadingRecordedEventType::ProcessAdded, KVP.Key.GetTagName(), Entry.ProcessName, Entry.Reason);
+		}
+	}
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Started recording loading events"));
+
+	return true;
+}
+
+bool ULoadingScreenSubsystem::StopEventRecording(const FString& FilePath)
+{
+	if (!EventRecorder.IsRecording())
+	{
+		return false;
+	}
+
+	EventRecorder.EndRecording();
+
+	const auto bSaved{ EventRecorder.Save(FilePath) };
+
+	EventRecorder.Reset();
+
+	return bSaved;
+}
+
+
+// Event Replay
+
+void ULoadingScreenSubsystem::TickEventReplay()
+{
+	const auto ReplayTime{ GetLoadingTime() - ReplayStartTime };
+
+	// Feed all inputs that are due, including those of the frames skipped by the replay speed
+
+	while (ReplayEvents.IsValidIndex(ReplayInputIndex) && (ReplayEvents[ReplayInputIndex].Time <= ReplayTime))
+	{
+		const auto& Event{ ReplayEvents[ReplayInputIndex++] };
+
+		if (Event.IsInput())
+		{
+			ApplyReplayedEvent(Event);
+		}
+	}
+}
+
+void ULoadingScreenSubsystem::ApplyReplayedEvent(const FLoadingRecordedEvent& Event)
+{
+	TGuardValue<bool> ApplyingReplayedEventGuard(bApplyingReplayedEvent, true);
+
+	ReplayResult.NumInputs++;
+
+	const auto Tag{ FGameplayTag::RequestGameplayTag(Event.LoadingTypeName, false) };
+
+	switch (Event.Type)
+	{
+	case ELoadingRecordedEventType::ProcessAdded:
+		AddLoadingProcess(Event.ProcessName, Tag, FText::FromString(Event.Reason));
+		break;
+
+	case ELoadingRecordedEventType::ProcessRemoved:
+		RemoveLoadingProcess(Event.ProcessName);
+		break;
+
+	case ELoadingRecordedEventType::TypeRemoved:
+		RemoveLoadingProcessByTag(Tag);
+		break;
+
+	case ELoadingRecordedEventType::ReasonChanged:
+		SetLoadingProcessReason(Event.ProcessName, FText::FromString(Event.Reason));
+		break;
+
+	case ELoadingRecordedEventType::BatchBegin:
+		ReplayBatchDepth++;
+		BeginLoadingProcessBatch();
+		break;
+
+	case ELoadingRecordedEventType::BatchEnd:
+		// Ignore batches that were opened before the recording started
+
+		if (ReplayBatchDepth > 0)
+		{
+			ReplayBatchDepth--;
+			EndLoadingProcessBatch();
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void ULoadingScreenSubsystem::CheckReplayedVisibility(bool bVisible)
+{
+	ReplayResult.NumVisibilityChanges++;
+
+	// Find the next visibility change in the recording
+
+	while (ReplayEvents.IsValidIndex(ReplayVisibilityIndex) && (ReplayEvents[ReplayVisibilityIndex].Type != ELoadingRecordedEventType::VisibilityChanged))
+	{
+		ReplayVisibilityIndex++;
+	}
+
+	const auto ReplayTime{ GetLoadingTime() - ReplayStartTime };
+
+	if (!ReplayEvents.IsValidIndex(ReplayVisibilityIndex))
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Replayed visibility change is not in the recording (Visible: %s, Time: %.3fs)"),
+			bVisible ? TEXT("TRUE") : TEXT("FALSE"), ReplayTime);
+
+		ReplayResult.NumVisibilityMismatches++;
+		return;
+	}
+
+	const auto& Expected{ ReplayEvents[ReplayVisibilityIndex++] };
+
+	ReplayResult.MaxVisibilityErrorSecs = FMath::Max(ReplayResult.MaxVisibilityErrorSecs, FMath::Abs(ReplayTime - Expected.Time));
+
+	if (Expected.bVisible != bVisible)
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Replayed visibility change does not match the recording (Visible: %s, Time: %.3fs, Recorded Time: %.3fs)"),
+			bVisible ? TEXT("TRUE") : TEXT("FALSE"), ReplayTime, Expected.Time);
+
+		ReplayResult.NumVisibilityMismatches++;
+	}
+}
+
+bool ULoadingScreenSubsystem::ShouldIgnoreLiveLoadingInput(FName ProcessName) const
+{
+	// Loading of the game would be mixed into the replayed decisions that are being measured
+
+	if (bReplayingEvents && !bApplyingReplayedEvent)
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Loading input was ignored while replaying loading events (ProcessName: %s)"), *WriteToString<64>(ProcessName));
+		return true;
+	}
+
+	return false;
+}
+
+bool ULoadingScreenSubsystem::IsEventReplayComplete() const
+{
+	return !ReplayEvents.IsValidIndex(ReplayInputIndex) && LoadingScreenInfos.IsEmpty() && !bLoadingWidgetDisplayed;
+}
+
+void ULoadingScreenSubsystem::FinishEventReplay()
+{
+	bReplayingEvents = false;
+	bHeadless = bHeadlessBeforeReplay;
+	bForceTickLoadingScreen = bForceTickLoadingScreenBeforeReplay;
+
+	// The watchdog was scheduled with the replay clock
+
+	NextWatchdogCheckTime = 0.0;
+
+	// Catch up with the state that was not applied while replaying
+
+	UpdateInputBlock();
+	UpdatePerformance();
+
+	// Recorded visibility changes that never happened are mismatches as well
+
+	const auto NumMissing{ FMath::Max(ReplayResult.NumExpectedVisibilityChanges - ReplayResult.NumVisibilityChanges, 0) };
+	ReplayResult.NumVisibilityMismatches += NumMissing;
+
+	const auto OverheadMs{ FPlatformTime::ToMilliseconds64(ReplayResult.OverheadCycles) };
+
+	UE_LOG(LogGameCore_LoadingScreen, Display, TEXT("Loading event replay finished (Inputs: %d, Frames: %d, Overhead: %.3fms, %.2fus/frame)"),
+		ReplayResult.NumInputs, ReplayResult.NumFrames, OverheadMs, (ReplayResult.NumFrames > 0) ? (OverheadMs * 1000.0 / ReplayResult.NumFrames) : 0.0);
+
+	UE_LOG(LogGameCore_LoadingScreen, Display, TEXT("  Visibility changes: %d/%d, Mismatches: %d, Max timing error: %.3fs"),
+		ReplayResult.NumVisibilityChanges, ReplayResult.NumExpectedVisibilityChanges, ReplayResult.NumVisibilityMismatches, ReplayResult.MaxVisibilityErrorSecs);
+
+	ReplayEvents.Empty();
+}
+
+bool ULoadingScreenSubsystem::StartEventReplay(const FString& FilePath, float Speed)
+{
+	if (bReplayingEvents || EventRecorder.IsRecording())
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Error, TEXT("Loading events cannot be replayed while recording or replaying"));
+		return false;
+	}
+
+	// The replay must start from a state without loading to be comparable with the recording
+
+	if (!LoadingScreenInfos.IsEmpty() || bLoadingWidgetDisplayed || IsLoadingProcessBatchOpen())
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Error, TEXT("Loading events cannot be replayed while loading"));
+		return false;
+	}
+
+	FLoadingEventRecorder Recording;
+	if (!Recording.Load(FilePath))
+	{
+		return false;
+	}
+
+	ReplayEvents = Recording.GetEvents();
+	ReplayInputIndex = 0;
+	ReplayVisibilityIndex = 0;
+	ReplayBatchDepth = 0;
+	ReplaySpeed = FMath::Max(Speed, 0.01f);
+	ReplayResult = FLoadingEventReplayResult();
+	ReplayResult.NumExpectedVisibilityChanges = Algo::CountIf(ReplayEvents, [](const FLoadingRecordedEvent& It) { return It.Type == ELoadingRecordedEventType::VisibilityChanged; });
+
+	// Replay in headless mode so that no widget, Slate or input work is done
+
+	bHeadlessBeforeReplay = bHeadless;
+	bForceTickLoadingScreenBeforeReplay = bForceTickLoadingScreen;
+	bHeadless = true;
+	bForceTickLoadingScreen = false;
+
+	ReplayStartTime = FPlatformTime::Seconds();
+	NextWatchdogCheckTime = 0.0;
+	bReplayingEvents = true;
+
+	UE_LOG(LogGameCore_LoadingScreen, Display, TEXT("Started replaying loading events (Events: %d, Speed: %.2f, Path: %s)"), ReplayEvents.Num(), ReplaySpeed, *FilePath);
+
+	return true;
+}
+
+void ULoadingScreenSubsystem::StopEventReplay()
+{
+	if (!bReplayingEvents)
+	{
+		return;
+	}
+
+	ReplayInputIndex = ReplayEvents.Num();
+
+	TGuardValue<bool> ApplyingReplayedEventGuard(bApplyingReplayedEvent, true);
+
+	// Close the batches and remove the loading left by the replay, so that it finishes on the next tick
+
+	while (ReplayBatchDepth > 0)
+	{
+		ReplayBatchDepth--;
+		EndLoadingProcessBatch();
+	}
+
+	TArray<FGameplayTag, TInlineAllocator<4>> RemainingTags;
+	LoadingScreenInfos.GetKeys(RemainingTags);
+
+	for (const auto& Tag : RemainingTags)
+	{
+		RemoveLoadingProcessByTag(Tag);
+	}
+}
+
+
+// Loading Screen Core
+
+FLoadingScreenCoreTypeSettings ULoadingScreenSubsystem::MakeCoreTypeSettings(const FLoadingScreenDefinition& Def) const
+{
+	FLoadingScreenCoreTypeSettings Settings;
+	Settings.ShowDelaySecs = Def.ShowDelaySecs;
+	Settings.AdditionalSecs = Def.AdditionalSecs;
+	Settings.MinVisibleSecs = Def.MinVisibleSecs;
+	Settings.bBlockInputs = Def.bBlockInputs && !bHeadless;
+	Settings.bSavingPerformance = Def.bSavingPerfomance;
+
+	return Settings;
+}
+
+double ULoadingScreenSubsystem::GetLoadingTime() const
+{
+	const auto CurrentTime{ FPlatformTime::Seconds() };
 
-	CancelPendingRemove(LoadingTypeTag);
+	return bReplayingEvents ? (ReplayStartTime + ((CurrentTime - ReplayStartTime) * ReplaySpeed)) : CurrentTime;
+}
 
-	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Add Loading process Exist type (Reason: %s, Handle: %s)"), *Reason.ToString(), *ProcessName.ToString());
+bool ULoadingScreenSubsystem::CanShowLoadingTypeImmediately(int32 TypeIndex) const
+{
+	// The widget still kept for reuse is displayed without waiting for the show delay
 
-	return true;
+	return ShowingWidgets.Contains(LoadingTypeTable[TypeIndex].LoadingTypeTag);
 }
 
-bool ULoadingScreenSubsystem::AddLoadingProcessNew(FName ProcessName, const FGameplayTag& LoadingTypeTag, const FText& Reason, const FLoadingScreenDefinition& Def)
+void ULoadingScreenSubsystem::HandleLoadingTypeShown(int32 TypeIndex)
 {
-	// Select Widget class
+	const auto& Tag{ LoadingTypeTable[TypeIndex].LoadingTypeTag };
+	const auto& Info{ LoadingScreenInfos[Tag] };
 
-	auto WidgetClass{ LoadingWidgetOverrides.FindRef(LoadingTypeTag) };
-	if (!WidgetClass)
-	{
-		const auto ClassPath{ Def.WidgetClass };
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Load screen displayed (Tag: %s)"), *WriteToString<64>(Tag.GetTagName()));
 
-		WidgetClass = ClassPath.TryLoadClass<UUserWidget>();
-	}
-	check(WidgetClass);
+	RecordLoadingEvent(ELoadingRecordedEventType::WidgetShown, Tag.GetTagName());
 
-	// Build Loading process info
+	CSV_EVENT(GCLoading, TEXT("Shown %s"), *WriteToString<64>(Tag.GetTagName()));
 
-	auto NewInfo{ FLoadingScreenInfo()};
-	NewInfo.Processes.Add(ProcessName, Reason);
-	NewInfo.WidgetClass = WidgetClass;
-	NewInfo.ZOrder = Def.ZOrder;
-	NewInfo.AdditionalSec = Def.AdditionalSecs;
-	NewInfo.bBlockInputs = Def.bBlockInputs;
-	NewInfo.bSavingPerfomance = Def.bSavingPerfomance;
+	MemoryTracker.AddLoadingType(Tag);
 
-	// Add to list
+	// Allocations made for the loading widget are tracked under a dedicated tag
 
-	LoadingScreenInfos.Add(LoadingTypeTag, NewInfo);
+	LLM_SCOPE_BYTAG(GCLoading_Widgets);
 
-	AddTagToPendingAddList(LoadingTypeTag);
+	// Create Widget, if has not created
+	
+	if (!bHeadless)
+	{
+		TryCreateLoadingWidget(Tag, Info.WidgetClass, Info.ZOrder, LoadingTypeTable[TypeIndex].Definition);
+	}
 
-	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Add Loading process new (Reason: %s, Handle: %s)"), *Reason.ToString(), *ProcessName.ToString());
+	// Perform Tick processing of slate
 
-	return true;
-}
+	if (bForceTickLoadingScreen)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GCLoading_ForceSlateTick);
 
+		FSlateApplication::Get().Tick();
+	}
 
-const FText& ULoadingScreenSubsystem::GetLoadingReasonFromName(FName ProcessName) const
-{
-	// Iterate LoadingScreenInfos
+	// Memory can be trimmed without being noticed while an opaque fullscreen widget is displayed
 
-	for (auto& KVP : LoadingScreenInfos)
+	if (LoadingTypeTable[TypeIndex].Definition.bOpaqueFullscreen)
 	{
-		// Search for Info containing handles
-
-		auto& Info{ KVP.Value };
-		auto& ProcessNameReasonMap{ Info.Processes };
-
-		if (auto* Reason{ ProcessNameReasonMap.Find(ProcessName) })
-		{
-			return *Reason;
-		}
+		bPendingMemoryTrim = true;
+		MemoryTrimReadyFrame = GFrameCounter + 1;
 	}
-
-	return FText::GetEmpty();
 }
 
-TArray<FText> ULoadingScreenSubsystem::GetLoadingReasonsFromTag(FGameplayTag LoadingTypeTag) const
+void ULoadingScreenSubsystem::HandleLoadingTypeHidden(int32 TypeIndex)
 {
-	TArray<FText> Reasons;
-
-	if (auto* Info{ LoadingScreenInfos.Find(LoadingTypeTag) })
-	{
-		Info->Processes.GenerateValueArray(Reasons);
-	}
+	const auto& Tag{ LoadingTypeTable[TypeIndex].LoadingTypeTag };
 
-	return Reasons;
-}
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Load screen hidden (Tag: %s)"), *WriteToString<64>(Tag.GetTagName()));
 
+	RecordLoadingEvent(ELoadingRecordedEventType::WidgetHidden, Tag.GetTagName());
 
-// Loading Widget
+	CSV_EVENT(GCLoading, TEXT("Hidden %s"), *WriteToString<64>(Tag.GetTagName()));
 
-void ULoadingScreenSubsystem::AddTagToPendingAddList(const FGameplayTag& Tag)
-{
-	PendingAddLoadingTags.Emplace(Tag);
+	// Remove from viewport
 
-	CancelPendingRemove(Tag);
+	TryRemoveLoadingWidget(Tag);
 }
 
-void ULoadingScreenSubsystem::AddTagToPendingRemoveList(const FGameplayTag& Tag)
+void ULoadingScreenSubsystem::HandleLoadingTypeSuppressed(int32 TypeIndex)
 {
-	const auto& CurrentTime{ FPlatformTime::Seconds() };
+	const auto& Tag{ LoadingTypeTable[TypeIndex].LoadingTypeTag };
 
-	PendingRemoveLoadingTags.Emplace(Tag, CurrentTime);
-}
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Load screen suppressed (Tag: %s)"), *WriteToString<64>(Tag.GetTagName()));
 
-void ULoadingScreenSubsystem::CancelPendingRemove(const FGameplayTag& Tag)
-{
-	PendingRemoveLoadingTags.Remove(Tag);
-}
+	RecordLoadingEvent(ELoadingRecordedEventType::WidgetSuppressed, Tag.GetTagName());
 
+	INC_DWORD_STAT(STAT_GCLoading_SuppressedShows);
+}
 
-void ULoadingScreenSubsystem::UpdateLoadingWidgets()
+void ULoadingScreenSubsystem::HandleLoadingTypesFinished(TConstArrayView<FLoadingScreenCoreFinishedType> FinishedTypes)
 {
-	// Process Pending Add
+	// Delete all Infos first, since listeners may add new loading processes
 
-	if (!PendingAddLoadingTags.IsEmpty())
-	{
-		const auto bForceTick{ !GIsEditor || GetDefault<ULoadingDeveloperSettings>()->bForceTickLoadingScreenInEditor };
+	TArray<TPair<FLoadingScreenInfo, double>, TInlineAllocator<2>> RemovedInfos;
 
-		for (auto It{ PendingAddLoadingTags.CreateIterator() }; It; ++It)
+	for (const auto& Finished : FinishedTypes)
+	{
+		FLoadingScreenInfo RemovedInfo;
+		if (LoadingScreenInfos.RemoveAndCopyValue(LoadingTypeTable[Finished.TypeIndex].LoadingTypeTag, RemovedInfo))
 		{
-			const auto& Tag{ *It };
-
-			if (ProcessPendingAddTag(Tag, bForceTick))
-			{
-				It.RemoveCurrent();
-			}
+			RemovedInfos.Emplace(MoveTemp(RemovedInfo), Finished.EndTime);
 		}
 	}
 
-	// Process Pending Remove
+	// Record and notify
 
-	if (!PendingRemoveLoadingTags.IsEmpty())
+	for (const auto& KVP : RemovedInfos)
 	{
-		const auto bCanHoldLoadingScreen{ !GIsEditor || GetDefault<ULoadingDeveloperSettings>()->bShouldHoldLoadingScreenAdditionalSecsInEditor };
-		const auto CurrentTime{ FPlatformTime::Seconds() };
+		const auto& RemovedInfo{ KVP.Key };
+		const auto& EndTime{ KVP.Value };
+		const auto Tag{ LoadingTypeTable[RemovedInfo.TypeIndex].LoadingTypeTag };
 
-		for (auto It{ PendingRemoveLoadingTags.CreateIterator() }; It; ++It)
-		{
-			const auto& Tag{ It->Key };
-			const auto& StartTime{ It->Value };
+		RecordLoadingHistory(Tag, NAME_None, EndTime - RemovedInfo.StartTime);
 
-			if (ProcessPendingRemoveTag(Tag, StartTime, CurrentTime, bCanHoldLoadingScreen))
-			{
-				// Delete Info at this time as well.
+		for (const auto& Entry : RemovedInfo.Processes)
+		{
+			RecordLoadingHistory(Tag, Entry.ProcessName, EndTime - Entry.StartTime);
+		}
 
-				LoadingScreenInfos.Remove(Tag);
+		ReleaseLoadingWidgetClass(RemovedInfo.TypeIndex);
 
-				It.RemoveCurrent();
-			}
-		}
+		NotifyAllLoadingProcessesRemoved(Tag, RemovedInfo);
 	}
+}
 
-	// Update and broadcast condition
+void ULoadingScreenSubsystem::HandleLoadingTypeDiscarded(int32 TypeIndex)
+{
+	const auto Tag{ LoadingTypeTable[TypeIndex].LoadingTypeTag };
 
-	const auto bNewLoadingScreenDisplayed{ !ShowingWidgets.IsEmpty() };
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Load screen discarded in batch (Tag: %s)"), *WriteToString<64>(Tag.GetTagName()));
 
-	if (bLoadingWidgetDisplayed != bNewLoadingScreenDisplayed)
+	RecordLoadingEvent(ELoadingRecordedEventType::WidgetSuppressed, Tag.GetTagName());
+
+	INC_DWORD_STAT(STAT_GCLoading_SuppressedShows);
+
+	FLoadingScreenInfo RemovedInfo;
+	if (!LoadingScreenInfos.RemoveAndCopyValue(Tag, RemovedInfo))
 	{
-		bLoadingWidgetDisplayed = bNewLoadingScreenDisplayed;
+		return;
+	}
+
+	// The loading still took place, so it is recorded like a loading that finished within its show delay
+
+	const auto EndTime{ GetLoadingTime() };
+
+	RecordLoadingHistory(Tag, NAME_None, EndTime - RemovedInfo.StartTime);
 
-		OnLoadingScreenVisibilityChanged.Broadcast(bLoadingWidgetDisplayed);
+	for (const auto& Entry : RemovedInfo.Processes)
+	{
+		RecordLoadingHistory(Tag, Entry.ProcessName, EndTime - Entry.StartTime);
 	}
+
+	ReleaseLoadingWidgetClass(TypeIndex);
+
+	NotifyAllLoadingProcessesRemoved(Tag, RemovedInfo);
 }
 
 
-bool ULoadingScreenSubsystem::ProcessPendingAddTag(const FGameplayTag& Tag, bool bForceTick)
+// Loading Widget
+
+void ULoadingScreenSubsystem::UpdateLoadingWidgets()
 {
-	auto& Info{ LoadingScreenInfos[Tag] };
+	SCOPE_CYCLE_COUNTER(STAT_GCLoading_UpdateLoadingWidgets);
 
-	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Load screen displayed (Tag: %s)"), *Tag.GetTagName().ToString());
+	// Process Pending Add and Remove
 
-	// Create Widget, if has not created
-	
-	TryCreateLoadingWidget(Tag, Info.WidgetClass, Info.ZOrder);
+	Core.Update();
 
-	// Update Input Block
+	// Destroy widgets that were not reused in time
 
-	if (Info.bBlockInputs)
+	if (NumLingeringWidgets > 0)
 	{
-		IncrementInputBlockCount();
+		ExpireLingeringWidgets(GetLoadingTime());
 	}
 
-	// Update Performance Saving
+	// Update composition of displayed widgets
 
-	if (Info.bSavingPerfomance)
+	if (bShowingWidgetsDirty)
 	{
-		IncrementSavingPerformanceCount();
-	}
-
-	// Perform Tick processing of slate
+		bShowingWidgetsDirty = false;
 
-	if (bForceTick)
-	{
-		FSlateApplication::Get().Tick();
+		UpdateWidgetOcclusion();
+		UpdatePresentationRate();
 	}
 
-	return true;
-}
+	// Update and broadcast condition
 
-bool ULoadingScreenSubsystem::ProcessPendingRemoveTag(const FGameplayTag& Tag, double StatTime, double CurrentTime, bool bShouldHold)
-{
-	auto& Info{ LoadingScreenInfos[Tag] };
-	auto* LocalGameInstance{ GetGameInstance() };
+	const auto bNewLoadingScreenDisplayed{ bHeadless ? Core.HasShownType() : HasDisplayedLoadingWidget() };
 
-	const auto HoldLoadingScreenAdditionalSecs{ bShouldHold ? Info.AdditionalSec : 0.0 };
-	
-	if (HoldLoadingScreenAdditionalSecs <= (CurrentTime - StatTime))
+	if (bLoadingWidgetDisplayed != bNewLoadingScreenDisplayed)
 	{
-		UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Load screen hidden (Tag: %s)"), *Tag.GetTagName().ToString());
+		bLoadingWidgetDisplayed = bNewLoadingScreenDisplayed;
 
-		// Update Input Block
+		// Replayed transitions do not load anything, so their memory is not tracked
 
-		if (Info.bBlockInputs)
+		if (!bReplayingEvents)
 		{
-			DecrementInputBlockCount();
-		}
-
-		// Update Performance Saving
+			if (bLoadingWidgetDisplayed)
+			{
+				MemoryTracker.BeginTransition(LoadingHistoryMapName);
 
-		if (Info.bSavingPerfomance)
-		{
-			DecrementSavingPerformanceCount();
+				for (const auto& KVP : ShowingWidgets)
+				{
+					if (!KVP.Value.bLingering)
+					{
+						MemoryTracker.AddLoadingType(KVP.Key);
+					}
+				}
+			}
+			else
+			{
+				MemoryTracker.EndTransition(LoadingHistoryMapName);
+			}
 		}
 
-		// Remove from viewport
+		RecordLoadingEvent(ELoadingRecordedEventType::VisibilityChanged, NAME_None, NAME_None, FText::GetEmpty(), bLoadingWidgetDisplayed);
 
-		TryRemoveLoadingWidget(Tag);
+		CSV_EVENT(GCLoading, bLoadingWidgetDisplayed ? TEXT("LoadingScreenShown") : TEXT("LoadingScreenHidden"));
 
-		return true;
+		if (bReplayingEvents)
+		{
+			CheckReplayedVisibility(bLoadingWidgetDisplayed);
+		}
+		else
+		{
+			OnLoadingScreenVisibilityChanged.Broadcast(bLoadingWidgetDisplayed);
+		}
 	}
-
-	return false;
 }
 
 
-void ULoadingScreenSubsystem::TryCreateLoadingWidget(const FGameplayTag& Tag, const TSubclassOf<UUserWidget>& Class, const int32& ZOrder)
+void ULoadingScreenSubsystem::TryCreateLoadingWidget(const FGameplayTag& Tag, const TSubclassOf<UUserWidget>& Class, const int32& ZOrder, const FLoadingScreenDefinition& Def)
 {
-	if (!ShowingWidgets.Contains(Tag))
+	// Reuse the widget hidden within the grace window instead of building a new one
+
+	if (auto* ShowingWidget{ ShowingWidgets.Find(Tag) })
+	{
+		if (ShowingWidget->bLingering)
+		{
+			UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Loading widget reused (Tag: %s)"), *WriteToString<64>(Tag.GetTagName()));
+
+			ShowingWidget->bLingering = false;
+
+			NumLingeringWidgets--;
+			bShowingWidgetsDirty = true;
+		}
+	}
+	else
 	{
+		SCOPE_CYCLE_COUNTER(STAT_GCLoading_CreateWidget);
+
 		auto* LocalGameInstance{ GetGameInstance() };
 
 		if (auto* Widget{ UUserWidget::CreateWidgetInstance(*LocalGameInstance, Class, NAME_None) })
 		{
 			// Add to viewport
 
-			auto SlateWidget{ Widget->TakeWidget() };
+			auto SlateWidget{ WrapLoadingWidget(Widget->TakeWidget(), Def) };
 
 			if (auto* GameViewportClient{ LocalGameInstance->GetGameViewportClient() })
 			{
@@ -499,7 +2136,9 @@ void ULoadingScreenSubsystem::TryCreateLoadingWidget(const FGameplayTag& Tag, co
 
 			// Add to list
 
-			ShowingWidgets.Add(Tag, SlateWidget.ToSharedPtr());
+			ShowingWidgets.Add(Tag, FLoadingScreenShowingWidget(SlateWidget, ZOrder, Def));
+
+			bShowingWidgetsDirty = true;
 		}
 		else
 		{
@@ -508,12 +2147,84 @@ void ULoadingScreenSubsystem::TryCreateLoadingWidget(const FGameplayTag& Tag, co
 	}
 }
 
+TSharedRef<SWidget> ULoadingScreenSubsystem::WrapLoadingWidget(const TSharedRef<SWidget>& SlateWidget, const FLoadingScreenDefinition& Def)
+{
+	switch (Def.RenderMode)
+	{
+	case ELoadingWidgetRenderMode::Invalidation:
+		{
+			UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Loading widget is rendered with invalidation"));
+
+			return SNew(SInvalidationPanel)
+				[
+					SlateWidget
+				];
+		}
+
+	case ELoadingWidgetRenderMode::Retainer:
+		{
+			UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Loading widget is rendered with retainer (Redraw every %d frames)"), Def.RetainerRedrawFrameInterval);
+
+			auto RetainerWidget
+			{
+				SNew(SRetainerWidget)
+					.RenderOnPhase(true)
+					.RenderOnInvalidation(false)
+					.Phase(0)
+					.PhaseCount(FMath::Max(Def.RetainerRedrawFrameInterval, 1))
+					.StatId(TEXT("GCLoadingRetainer"))
+					[
+						SlateWidget
+					]
+			};
+
+			RetainerWidget->SetRetainedRendering(true);
+
+			return RetainerWidget;
+		}
+
+	default:
+		return SlateWidget;
+	}
+}
+
 void ULoadingScreenSubsystem::TryRemoveLoadingWidget(const FGameplayTag& Tag)
 {
-	auto SlateWidget{ ShowingWidgets.FindRef(Tag) };
+	auto* ShowingWidget{ ShowingWidgets.Find(Tag) };
+
+	if (!ShowingWidget)
+	{
+		return;
+	}
+
+	// Keep the widget displayed for reuse within the grace window, so that back-to-back loading does not flicker
+
+	if (ShowingWidget->ReuseGraceSecs > 0.0f)
+	{
+		if (!ShowingWidget->bLingering)
+		{
+			ShowingWidget->bLingering = true;
+			ShowingWidget->LingerStartTime = GetLoadingTime();
+
+			NumLingeringWidgets++;
+			bShowingWidgetsDirty = true;
+		}
+
+		return;
+	}
+
+	DestroyLoadingWidget(Tag);
+}
+
+void ULoadingScreenSubsystem::DestroyLoadingWidget(const FGameplayTag& Tag)
+{
+	auto ShowingWidget{ ShowingWidgets.FindRef(Tag) };
+	auto& SlateWidget{ ShowingWidget.SlateWidget };
 
 	if (SlateWidget.IsValid())
 	{
+		SCOPE_CYCLE_COUNTER(STAT_GCLoading_RemoveWidget);
+
 		GEngine->ForceGarbageCollection(true);
 
 		if (auto* GameViewportClient{ GetGameInstance()->GetGameViewportClient() })
@@ -524,18 +2235,27 @@ void ULoadingScreenSubsystem::TryRemoveLoadingWidget(const FGameplayTag& Tag)
 		SlateWidget.Reset();
 
 		ShowingWidgets.Remove(Tag);
+
+		if (ShowingWidget.bLingering)
+		{
+			NumLingeringWidgets--;
+		}
+
+		bShowingWidgetsDirty = true;
 	}
 }
 
 void ULoadingScreenSubsystem::RemoveAllWidgets()
 {
+	SCOPE_CYCLE_COUNTER(STAT_GCLoading_RemoveWidget);
+
 	auto* GameViewportClient{ GetGameInstance()->GetGameViewportClient() };
 
 	GEngine->ForceGarbageCollection(true);
 
 	for (auto It{ ShowingWidgets.CreateIterator() }; It; ++It)
 	{
-		auto& SlateWidget{ It->Value };
+		auto& SlateWidget{ It->Value.SlateWidget };
 
 		if (SlateWidget.IsValid())
 		{
@@ -549,6 +2269,80 @@ void ULoadingScreenSubsystem::RemoveAllWidgets()
 
 		It.RemoveCurrent();
 	}
+
+	NumLingeringWidgets = 0;
+	bShowingWidgetsDirty = false;
+}
+
+void ULoadingScreenSubsystem::ExpireLingeringWidgets(double CurrentTime)
+{
+	// Keep a single widget instance for the whole seamless travel including the transition map
+
+	const auto* World{ GetGameInstance()->GetWorld() };
+
+	if (World && World->IsInSeamlessTravel())
+	{
+		return;
+	}
+
+	TArray<FGameplayTag, TInlineAllocator<2>> ExpiredTags;
+
+	for (const auto& KVP : ShowingWidgets)
+	{
+		const auto& ShowingWidget{ KVP.Value };
+
+		if (ShowingWidget.bLingering && ((CurrentTime - ShowingWidget.LingerStartTime) >= ShowingWidget.ReuseGraceSecs))
+		{
+			ExpiredTags.Add(KVP.Key);
+		}
+	}
+
+	for (const auto& Tag : ExpiredTags)
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Loading widget was not reused in time (Tag: %s)"), *WriteToString<64>(Tag.GetTagName()));
+		DestroyLoadingWidget(Tag);
+	}
+}
+
+bool ULoadingScreenSubsystem::HasDisplayedLoadingWidget() const
+{
+	return !ShowingWidgets.IsEmpty();
+}
+
+void ULoadingScreenSubsystem::UpdateWidgetOcclusion()
+{
+	// Find the top most opaque fullscreen widget
+
+	auto TopOpaqueZOrder{ TNumericLimits<int32>::Lowest() };
+
+	for (const auto& KVP : ShowingWidgets)
+	{
+		if (KVP.Value.bOpaqueFullscreen)
+		{
+			TopOpaqueZOrder = FMath::Max(TopOpaqueZOrder, KVP.Value.ZOrder);
+		}
+	}
+
+	// Collapse the widgets below it and restore the others
+
+	for (auto& KVP : ShowingWidgets)
+	{
+		auto& ShowingWidget{ KVP.Value };
+
+		const auto bShouldOcclude{ ShowingWidget.ZOrder < TopOpaqueZOrder };
+
+		if (ShowingWidget.bOccluded == bShouldOcclude)
+		{
+			continue;
+		}
+
+		const auto bWasCollapsed{ ShowingWidget.IsCollapsed() };
+
+		ShowingWidget.bOccluded = bShouldOcclude;
+		ShowingWidget.UpdateCollapsed(bWasCollapsed);
+
+		UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Loading widget %s (Tag: %s)"), bShouldOcclude ? TEXT("occluded") : TEXT("restored"), *WriteToString<64>(KVP.Key.GetTagName()));
+	}
 }
 
 
@@ -563,7 +2357,14 @@ bool ULoadingScreenSubsystem::IsShowingInitialLoadingScreen() const
 
 void ULoadingScreenSubsystem::UpdateInputBlock()
 {
-	const auto bNewInputBlocked{ InputBlockCount > 0 };
+	// The replay must not change the input of the game
+
+	if (bReplayingEvents)
+	{
+		return;
+	}
+
+	const auto bNewInputBlocked{ Core.IsInputBlocked() };
 
 	if (bInputBlocked != bNewInputBlocked)
 	{
@@ -571,21 +2372,15 @@ void ULoadingScreenSubsystem::UpdateInputBlock()
 
 		UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Input Block: %s"), bInputBlocked ? TEXT("ENABLED") : TEXT("DISABLED"));
 
+		// The input preprocessor is shared by all game instances in the process
+
 		if (bInputBlocked)
 		{
-			if (!InputPreProcessor.IsValid())
-			{
-				InputPreProcessor = MakeShareable<FLoadingScreenInputPreProcessor>(new FLoadingScreenInputPreProcessor());
-				FSlateApplication::Get().RegisterInputPreProcessor(InputPreProcessor, 0);
-			}
+			FLoadingGlobalStateArbiter::Get().AcquireInputBlock();
 		}
 		else
 		{
-			if (InputPreProcessor.IsValid())
-			{
-				FSlateApplication::Get().UnregisterInputPreProcessor(InputPreProcessor);
-				InputPreProcessor.Reset();
-			}
+			FLoadingGlobalStateArbiter::Get().ReleaseInputBlock();
 		}
 	}
 }
@@ -595,7 +2390,14 @@ void ULoadingScreenSubsystem::UpdateInputBlock()
 
 void ULoadingScreenSubsystem::UpdatePerformance()
 {
-	const auto bNewSavingPerformance{ SavingPerformanceCount > 0 };
+	// The replay must not change the rendering and loading priority of the game
+
+	if (bReplayingEvents)
+	{
+		return;
+	}
+
+	const auto bNewSavingPerformance{ Core.IsSavingPerformance() };
 
 	if (bSavingPerformance != bNewSavingPerformance)
 	{
@@ -603,9 +2405,16 @@ void ULoadingScreenSubsystem::UpdatePerformance()
 
 		UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Saving Performance: %s"), bSavingPerformance ? TEXT("ENABLED") : TEXT("DISABLED"));
 
-		// Change shader batch mode
+		// Change shader batch mode and hang detection, which are shared by all game instances in the process
 
-		FShaderPipelineCache::SetBatchMode(bSavingPerformance ? FShaderPipelineCache::BatchMode::Fast : FShaderPipelineCache::BatchMode::Background);
+		if (bSavingPerformance)
+		{
+			FLoadingGlobalStateArbiter::Get().AcquireSavingPerformance();
+		}
+		else
+		{
+			FLoadingGlobalStateArbiter::Get().ReleaseSavingPerformance();
+		}
 
 		// Disable world rendering
 
@@ -623,27 +2432,72 @@ void ULoadingScreenSubsystem::UpdatePerformance()
 				}
 			}
 		}
+	}
+}
 
-		// Obtain and apply HangDurationMultiplier from GConfig on the load screen
 
-		if (bSavingPerformance)
-		{
-			auto HangDurationMultiplier{ 0.0 };
-			if (!GConfig || !GConfig->GetDouble(TEXT("Core.System"), TEXT("LoadingScreenHangDurationMultiplier"), HangDurationMultiplier, GEngineIni))
-			{
-				HangDurationMultiplier = 1.0;
-			}
+// Presentation Rate
 
-			FThreadHeartBeat::Get().SetDurationMultiplier(HangDurationMultiplier);
-			FGameThreadHitchHeartBeat::Get().SuspendHeartBeat();
-		}
+void ULoadingScreenSubsystem::UpdatePresentationRate()
+{
+	auto NewPresentationRate{ 0.0f };
+
+	for (const auto& KVP : ShowingWidgets)
+	{
+		const auto& Rate{ KVP.Value.TargetPresentationRate };
 
-		// Restore the original settings
+		if ((Rate > 0.0f) && ((NewPresentationRate <= 0.0f) || (Rate < NewPresentationRate)))
+		{
+			NewPresentationRate = Rate;
+		}
+	}
 
+	if (AppliedPresentationRate != NewPresentationRate)
+	{
+		if (NewPresentationRate > 0.0f)
+		{
+			ApplyPresentationRate(NewPresentationRate);
+		}
 		else
 		{
-			FThreadHeartBeat::Get().SetDurationMultiplier(1.0);
-			FGameThreadHitchHeartBeat::Get().ResumeHeartBeat();
+			RestorePresentationRate();
 		}
 	}
 }
+
+void ULoadingScreenSubsystem::ApplyPresentationRate(float Rate)
+{
+	if (AppliedPresentationRate <= 0.0f)
+	{
+		PresentationRateStartTime = FPlatformTime::Seconds();
+		PresentationRateStartFrame = GFrameCounter;
+	}
+
+	AppliedPresentationRate = Rate;
+
+	// The rate is shared by all game instances in the process, so the lowest requested rate is applied
+
+	const auto* DevSettings{ GetDefault<ULoadingDeveloperSettings>() };
+
+	FLoadingGlobalStateArbiter::Get().RequestPresentationRate(this, Rate, DevSettings->PresentationRateAsyncLoadingTimeShare);
+}
+
+void ULoadingScreenSubsystem::RestorePresentationRate()
+{
+	if (AppliedPresentationRate <= 0.0f)
+	{
+		return;
+	}
+
+	FLoadingGlobalStateArbiter::Get().RequestPresentationRate(this, 0.0f, 0.0f);
+
+	// Report the time spent loading at the limited rate
+
+	const auto Duration{ FPlatformTime::Seconds() - PresentationRateStartTime };
+	const auto NumFrames{ GFrameCounter - PresentationRateStartFrame };
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Presentation rate released (Limit: %.1f Hz, Duration: %.3fs, Frames: %llu, Average: %.1f fps)"),
+		AppliedPresentationRate, Duration, NumFrames, (Duration > 0.0) ? (NumFrames / Duration) : 0.0);
+
+	AppliedPresentationRate = 0.0f;
+}
@@ -6,15 +6,26 @@
 #include "Tickable.h"
 
 #include "LoadingScreenInputPreProcessor.h"
+#include "LoadingDeveloperSettings.h"
+#include "LoadingScreenCore.h"
+#include "History/LoadingHistoryDatabase.h"
+#include "Diagnostics/LoadingScreenHitchDetector.h"
+#include "Diagnostics/LoadingMemoryTracker.h"
+#include "Diagnostics/LoadingEventRecorder.h"
+#include "Diagnostics/LoadingWatchdogThread.h"
 
 #include "GameplayTagContainer.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Layout/Visibility.h"
 
 #include "LoadingScreenSubsystem.generated.h"
 
 class SWidget;
 class UUserWidget;
 class ULoadingObserver;
-struct FLoadingScreenDefinition;
+class UPendingNetGame;
+struct FWorldContext;
 
 
 /**
@@ -23,6 +34,74 @@ struct FLoadingScreenDefinition;
 DECLARE_MULTICAST_DELEGATE_OneParam(FLoadingScreenVisibilityChangedDelegate, bool);
 
 
+/**
+ * Type of change made to the loading process
+ */
+UENUM(BlueprintType)
+enum class ELoadingProcessChangeType : uint8
+{
+	Added,
+	Removed,
+	ReasonChanged
+};
+
+/**
+ * Delegate notifies you that the loading process of the loading type has been changed.
+ */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FLoadingProcessChangedDelegate, FGameplayTag, FName, ELoadingProcessChangeType);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FLoadingProcessChangedDynamicDelegate, FGameplayTag, LoadingTypeTag, FName, ProcessName, ELoadingProcessChangeType, ChangeType);
+
+/**
+ * Delegate notifies you that the loading took longer than the 95th percentile of its history.
+ * 
+ * Params:
+ *	LoadingTypeTag, MapName, ProcessName (NAME_None for the whole loading type), Duration, HistoricalP95
+ */
+DECLARE_MULTICAST_DELEGATE_FiveParams(FLoadingSlowerThanHistoryDelegate, FGameplayTag, FName, FName, float, float);
+
+
+/**
+ * Ongoing loading process and its reason
+ */
+USTRUCT(BlueprintType)
+struct FLoadingProcessEntry
+{
+	GENERATED_BODY()
+public:
+	FLoadingProcessEntry() {}
+
+	FLoadingProcessEntry(FName InProcessName, const FText& InReason, double InStartTime)
+		: ProcessName(InProcessName), Reason(InReason), StartTime(InStartTime)
+	{}
+
+public:
+	//
+	// Name of the loading process
+	//
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FName ProcessName{ NAME_None };
+
+	//
+	// Reason of the loading process
+	//
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FText Reason;
+
+	//
+	// Time when the loading process was added
+	//
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	double StartTime{ 0.0 };
+
+	//
+	// Number of seconds this loading process is expected to take based on its history (negative if unknown)
+	//
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	float ExpectedDuration{ -1.0f };
+
+};
+
+
 /**
  * Information on ongoing loading
  */
@@ -33,12 +112,21 @@ struct FLoadingScreenInfo
 public:
 	FLoadingScreenInfo() {}
 
+	/**
+	 * Number of loading processes that can be stored without heap allocation
+	 */
+	static constexpr int32 NumInlineProcesses{ 4 };
+
 public:
 	//
-	// Mapping list of process name and reasons
+	// List of process name and reasons
+	// 
+	// Tip:
+	//	Almost every loading type has only a few processes, so they are stored inline.
+	//	Since reflected containers cannot use inline allocators, this is not a UPROPERTY.
+	//	Blueprints can get a copy with ULoadingScreenSubsystem::GetLoadingProcessesFromTag().
 	//
-	UPROPERTY(BlueprintReadWrite, EditAnywhere)
-	TMap<FName, FText> Processes;
+	TArray<FLoadingProcessEntry, TInlineAllocator<NumInlineProcesses>> Processes;
 
 	//
 	// Widget class for this loading screen
@@ -70,6 +158,187 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	bool bSavingPerfomance{ true };
 
+	//
+	// Time when the first loading process of this loading type was added
+	//
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	double StartTime{ 0.0 };
+
+	//
+	// Number of seconds this loading type is expected to take based on its history (negative if unknown)
+	//
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	float ExpectedDuration{ -1.0f };
+
+	//
+	// Index of this loading type in the compiled loading type table
+	//
+	UPROPERTY()
+	int32 TypeIndex{ INDEX_NONE };
+
+public:
+	FLoadingProcessEntry* FindProcess(FName ProcessName)
+	{
+		return Processes.FindByPredicate([ProcessName](const FLoadingProcessEntry& It) { return It.ProcessName == ProcessName; });
+	}
+
+	const FLoadingProcessEntry* FindProcess(FName ProcessName) const
+	{
+		return Processes.FindByPredicate([ProcessName](const FLoadingProcessEntry& It) { return It.ProcessName == ProcessName; });
+	}
+
+	FText* FindReason(FName ProcessName)
+	{
+		auto* Entry{ FindProcess(ProcessName) };
+		return Entry ? &Entry->Reason : nullptr;
+	}
+
+	const FText* FindReason(FName ProcessName) const
+	{
+		const auto* Entry{ FindProcess(ProcessName) };
+		return Entry ? &Entry->Reason : nullptr;
+	}
+
+	bool ContainsProcess(FName ProcessName) const
+	{
+		return FindReason(ProcessName) != nullptr;
+	}
+
+	FLoadingProcessEntry& AddProcess(FName ProcessName, const FText& Reason, double InStartTime)
+	{
+		return Processes.Emplace_GetRef(ProcessName, Reason, InStartTime);
+	}
+
+	bool RemoveProcess(FName ProcessName)
+	{
+		const auto Index{ Processes.IndexOfByPredicate([ProcessName](const FLoadingProcessEntry& It) { return It.ProcessName == ProcessName; }) };
+
+		if (Index != INDEX_NONE)
+		{
+			Processes.RemoveAt(Index);
+			return true;
+		}
+
+		return false;
+	}
+
+};
+
+
+/**
+ * Definition of the loading type compiled from the developer settings and the widget overrides
+ */
+USTRUCT()
+struct FLoadingScreenTypeEntry
+{
+	GENERATED_BODY()
+public:
+	FLoadingScreenTypeEntry() {}
+
+public:
+	//
+	// Loading type tag of this entry
+	//
+	UPROPERTY()
+	FGameplayTag LoadingTypeTag;
+
+	//
+	// Copy of the definition set in the developer settings
+	//
+	UPROPERTY()
+	FLoadingScreenDefinition Definition;
+
+	//
+	// Widget class overriding the one in the definition
+	//
+	UPROPERTY()
+	TSoftClassPtr<UUserWidget> OverrideWidgetClass;
+
+	//
+	// Widget class kept in memory according to the residency policy of the definition
+	//
+	UPROPERTY()
+	TSubclassOf<UUserWidget> ResidentWidgetClass{ nullptr };
+
+	//
+	// Whether the loading type is currently defined in the developer settings
+	//
+	UPROPERTY()
+	bool bDefined{ false };
+
+};
+
+
+/**
+ * Loading widget added to the viewport and its composition state
+ */
+struct FLoadingScreenShowingWidget
+{
+public:
+	FLoadingScreenShowingWidget() {}
+
+	FLoadingScreenShowingWidget(const TSharedRef<SWidget>& InSlateWidget, int32 InZOrder, const FLoadingScreenDefinition& Def)
+		: SlateWidget(InSlateWidget)
+		, ZOrder(InZOrder)
+		, TargetPresentationRate(Def.TargetPresentationRate)
+		, ReuseGraceSecs(Def.ReuseGraceSecs)
+		, bOpaqueFullscreen(Def.bOpaqueFullscreen)
+	{}
+
+public:
+	//
+	// Widget added to the viewport
+	//
+	TSharedPtr<SWidget> SlateWidget;
+
+	//
+	// ZOrder of the widget in the viewport
+	//
+	int32 ZOrder{ 0 };
+
+	//
+	// Frame rate at which the game is presented while the widget is displayed
+	//
+	float TargetPresentationRate{ 0.0f };
+
+	//
+	// Number of seconds to keep displaying the widget for reuse after loading ends
+	//
+	float ReuseGraceSecs{ 0.0f };
+
+	//
+	// Time at which loading ended and the widget started waiting for reuse
+	//
+	double LingerStartTime{ 0.0 };
+
+	//
+	// Whether the widget covers the whole screen with opaque content
+	//
+	bool bOpaqueFullscreen{ false };
+
+	//
+	// Whether the widget is collapsed because it is covered by an opaque fullscreen widget
+	//
+	bool bOccluded{ false };
+
+	//
+	// Whether loading has ended and the widget is kept displayed while waiting to be reused
+	//
+	bool bLingering{ false };
+
+	//
+	// Visibility of the widget before it was collapsed
+	//
+	EVisibility VisibilityBeforeCollapse{ EVisibility::Visible };
+
+public:
+	bool IsCollapsed() const { return bOccluded; }
+
+	/**
+	 * Applies the visibility and ticking of the widget after bOccluded has changed
+	 */
+	void UpdateCollapsed(bool bWasCollapsed);
+
 };
 
 
@@ -80,6 +349,8 @@ UCLASS()
 class GCLOADING_API ULoadingScreenSubsystem 
 	: public UGameInstanceSubsystem
 	, public FTickableGameObject
+	, public ILoadingScreenCoreClock
+	, public ILoadingScreenCoreListener
 {
 	GENERATED_BODY()
 public:
@@ -103,6 +374,28 @@ public:
 	virtual UWorld* GetTickableGameObjectWorld() const override;
 
 
+	////////////////////////////////////////////////////////
+	// Headless
+protected:
+	//
+	// Whether loading is tracked without any widget, Slate or input work
+	//
+	bool bHeadless{ false };
+
+protected:
+	/**
+	 * Returns whether the subsystem should run in headless mode
+	 */
+	virtual bool ShouldUseHeadlessMode() const;
+
+public:
+	/**
+	 * Returns whether loading is tracked without displaying any widget
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Loading Screen")
+	bool IsHeadless() const { return bHeadless; }
+
+
 	////////////////////////////////////////////////////////
 	// Loading Observer
 protected:
@@ -112,20 +405,34 @@ protected:
 	UPROPERTY(Transient)
 	TArray<TObjectPtr<ULoadingObserver>> ActiveObservers;
 
+	//
+	// Whether thread-safe loading observers are evaluated in parallel
+	//
+	bool bEvaluateObserversInParallel{ true };
+
 protected:
 	void InitializeObservers();
 	void DeinitializeObservers();
 	void TickObservers(float DeltaTime);
 
+public:
+	/**
+	 * Returns the loading observers created from the developer settings
+	 */
+	const TArray<TObjectPtr<ULoadingObserver>>& GetActiveObservers() const { return ActiveObservers; }
+
 
 	////////////////////////////////////////////////////////
 	// Loading Widget Override
 public:
 	//
 	// Mapping list of loading type tags and widget classes that override the widget to be displayed during loading .
+	// 
+	// Tip:
+	//	Classes are weakly referenced so that they can be released according to the residency policy.
 	//
 	UPROPERTY(Transient)
-	TMap<FGameplayTag, TSubclassOf<UUserWidget>> LoadingWidgetOverrides;
+	TMap<FGameplayTag, TSoftClassPtr<UUserWidget>> LoadingWidgetOverrides;
 
 public:
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Loading Screen", meta = (GameplayTagFilter = "LoadingType"))
@@ -133,162 +440,739 @@ public:
 
 
 	////////////////////////////////////////////////////////
-	// Loading Processes Infos
-public:
+	// Loading Type Table
+protected:
 	//
-	// Mapping list of handles with information on ongoing loading process
+	// List of loading type definitions compiled from the developer settings and the widget overrides
+	// 
+	// Tip:
+	//	Entries are never removed or reordered, so an index always refers to the same loading type.
 	//
 	UPROPERTY(Transient)
-	TMap<FGameplayTag, FLoadingScreenInfo> LoadingScreenInfos;
+	TArray<FLoadingScreenTypeEntry> LoadingTypeTable;
 
-public:
-	/**
-	 * Loading screen notifies the start of the required loading process
-	 * 
-	 * !!!Note!!!:
-	 *	Be sure to save the Handle and delete it using RemoveLoadingProcess() when the process is finished. 
-	 *	Otherwise, the loading widget will remain.
-	 */
-	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Loading Screen", meta = (GameplayTagFilter = "LoadingType"))
-	bool AddLoadingProcess(FName ProcessName, FGameplayTag LoadingTypeTag, FText Reason);
+	//
+	// Mapping list of loading type tags and their indices in LoadingTypeTable
+	//
+	TMap<FGameplayTag, int32> LoadingTypeIndices;
 
-	/**
-	 * Notifies the end of the loading process
-	 */
-	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Loading Screen")
-	bool RemoveLoadingProcess(FName ProcessName);
+	//
+	// Whether Slate is ticked when the loading widget is displayed
+	//
+	bool bForceTickLoadingScreen{ true };
 
-	/**
-	 * Notifies the end of the loading process using tag
-	 */
-	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Loading Screen", meta = (GameplayTagFilter = "LoadingType"))
-	bool RemoveLoadingProcessByTag(FGameplayTag LoadingTypeTag);
+	//
+	// Frame time in seconds above which a frame is treated as a hitch (0 disables detection)
+	//
+	float LoadingScreenHitchThresholdSecs{ 0.0f };
 
 protected:
-	virtual bool AddLoadingProcessExistType(FLoadingScreenInfo& Info, FName ProcessName, const FGameplayTag& LoadingTypeTag, const FText& Reason);
-	virtual bool AddLoadingProcessNew(FName ProcessName, const FGameplayTag& LoadingTypeTag, const FText& Reason, const FLoadingScreenDefinition& Def);
-
-public:
 	/**
-	 * Get loading reason from handle
+	 * Compiles the developer settings and the widget overrides into LoadingTypeTable
 	 */
-	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Loading Screen")
-	virtual const FText& GetLoadingReasonFromName(FName ProcessName) const;
+	void RebuildLoadingTypeTable();
+
+	int32 FindLoadingTypeIndex(const FGameplayTag& LoadingTypeTag) const;
 
+#if WITH_EDITOR
+	void HandleDeveloperSettingsChanged(UObject* Settings, FPropertyChangedEvent& PropertyChangedEvent);
+#endif
+
+public:
 	/**
-	 * Get loading reasons from tag
+	 * Returns whether the loading type currently has an ongoing loading process
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Loading Screen", meta = (GameplayTagFilter = "LoadingType"))
-	virtual TArray<FText> GetLoadingReasonsFromTag(FGameplayTag LoadingTypeTag) const;
+	bool IsLoadingTypeActive(FGameplayTag LoadingTypeTag) const;
 
 
 	////////////////////////////////////////////////////////
-	// Loading Widgets
-public:
-	FLoadingScreenVisibilityChangedDelegate OnLoadingScreenVisibilityChanged;
-
+	// Memory Trim
 protected:
 	//
-	// List of loading type tags for which the loading process is started and the loading widget needs to be added
+	// Whether memory should be trimmed once the opaque fullscreen loading screen has been presented
 	//
-	UPROPERTY(Transient)
-	TSet<FGameplayTag> PendingAddLoadingTags;
+	bool bPendingMemoryTrim{ false };
 
 	//
-	// Mapping List of loading type tags for which the loading process is finished and the loading widget needs to be removed
+	// First frame at whose end the opaque fullscreen loading screen has been presented and memory can be trimmed
 	// 
-	// Key	 : LoadingTypeTag
-	// Value : Start time of removal
-	//
-	UPROPERTY(Transient)
-	TMap<FGameplayTag, double> PendingRemoveLoadingTags;
-
+	// Tip:
+	//	The widget is added during the tick and painted at the end of the frame, so trimming in the same tick would stall before the screen is visible.
 	//
-	// Mapping list of loading widgets and their tags currently displayed
-	//
-	TMap<FGameplayTag, TSharedPtr<SWidget>> ShowingWidgets;
+	uint64 MemoryTrimReadyFrame{ 0 };
 
 	//
-	// Whether the loading screen is currently displayed or not
+	// Whether garbage collection was requested to run while an opaque fullscreen loading screen is displayed
 	//
-	UPROPERTY(Transient)
-	bool bLoadingWidgetDisplayed{ false };
+	bool bPendingGarbageCollectionRequest{ false };
 
 protected:
-	void AddTagToPendingAddList(const FGameplayTag & Tag);
-	void AddTagToPendingRemoveList(const FGameplayTag& Tag);
-	void CancelPendingRemove(const FGameplayTag& Tag);
-
-	void UpdateLoadingWidgets();
+	/**
+	 * Releases cached memory while an opaque fullscreen loading screen hides the transition
+	 */
+	void TrimMemoryForTransition();
 
-	bool ProcessPendingAddTag(const FGameplayTag& Tag, bool bForceTick);
-	bool ProcessPendingRemoveTag(const FGameplayTag& Tag, double StatTime, double CurrentTime, bool bShouldHold);
+	void HandleEndFrameForMemoryTrim();
 
-	void TryCreateLoadingWidget(const FGameplayTag& Tag, const TSubclassOf<UUserWidget>& Class, const int32& ZOrder);
-	void TryRemoveLoadingWidget(const FGameplayTag& Tag);
-	void RemoveAllWidgets();
+	void RunRequestedGarbageCollection();
 
+public:
 	/**
-	 * Returns whether or not the initialization load screen is being displayed before the normal load screen.
+	 * Requests garbage collection to run while an opaque fullscreen loading screen hides it from the player.
+	 * 
+	 * Tip:
+	 *	If an opaque fullscreen loading screen has been presented, it runs at the end of the current frame.
+	 *	Otherwise, it runs after the next opaque fullscreen loading screen has been presented.
 	 */
-	bool IsShowingInitialLoadingScreen() const;
+	UFUNCTION(BlueprintCallable, Category = "Loading Screen")
+	void RequestGarbageCollectionDuringLoadingScreen();
 
-public:
 	/**
-	 * Get loading reasons from tag
+	 * Returns whether a loading screen that covers the whole screen with opaque content is displayed
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Loading Screen")
-	virtual bool IsLoadingWidgetDisplayed() const { return bLoadingWidgetDisplayed; }
+	bool IsOpaqueLoadingScreenDisplayed() const;
 
 
 	////////////////////////////////////////////////////////
-	// Input
+	// Widget Class Residency
 protected:
 	//
-	// Processor to process input while the loading screen is displayed.
+	// Manager used to load widget classes ahead of their use
 	//
-	TSharedPtr<IInputProcessor> InputPreProcessor;
+	FStreamableManager WidgetClassStreamableManager;
 
 	//
-	// Number of loading screens that need to be input blocked
+	// Handles of widget classes being loaded ahead of their use, indexed by loading type index
 	//
-	UPROPERTY(Transient)
-	int32 InputBlockCount{ 0 };
+	TArray<TSharedPtr<FStreamableHandle>> WidgetClassPrefetchHandles;
 
 	//
-	// Whether the input is currently blocked or not
+	// Memory used when a widget class with the PreloadBeforeUse policy was released
+	// 
+	// Tip:
+	//	Once the next garbage collection has reclaimed the class, the freed memory is logged and the class is loaded again in the background.
 	//
-	UPROPERTY(Transient)
-	bool bInputBlocked{ false };
+	uint64 WidgetClassReleaseBytes{ 0 };
+
+	//
+	// Whether released widget classes with the PreloadBeforeUse policy are waiting for the next garbage collection to be loaded again
+	//
+	bool bPendingWidgetClassRePrefetch{ false };
 
 protected:
-	virtual void UpdateInputBlock();
+	TSoftClassPtr<UUserWidget> GetLoadingWidgetClassPath(int32 TypeIndex) const;
 
-	void IncrementInputBlockCount() { InputBlockCount++; UpdateInputBlock(); }
-	void DecrementInputBlockCount() { InputBlockCount--; UpdateInputBlock(); }
-	void ClearInputBlockCount() { InputBlockCount = 0; UpdateInputBlock(); }
+	/**
+	 * Returns the widget class of the loading type, loading it if necessary
+	 */
+	TSubclassOf<UUserWidget> ResolveLoadingWidgetClass(int32 TypeIndex);
 
-	
-	////////////////////////////////////////////////////////
-	// Performace
-protected:
-	//
-	// Number of loading screens that need to be saved performance
-	//
-	UPROPERTY(Transient)
-	int32 SavingPerformanceCount{ 0 };
+	/**
+	 * Releases the widget class of the loading type if its residency policy allows
+	 */
+	void ReleaseLoadingWidgetClass(int32 TypeIndex);
 
-	//
-	// Whether the peformance is currently saved or not
-	//
-	UPROPERTY(Transient)
-	bool bSavingPerformance{ false };
+	void PrefetchLoadingWidgetClass(int32 TypeIndex);
+	void HandleLoadingWidgetClassPrefetched(int32 TypeIndex);
 
-protected:
-	virtual void UpdatePerformance();
+	void HandleSeamlessTravelStart(UWorld* World, const FString& LevelName);
+	void HandlePreClientTravel(const FString& PendingURL, ETravelType TravelType, bool bIsSeamlessTravel);
+	void HandlePendingNetGameConnectionCreated(UPendingNetGame* PendingNetGame);
+	void HandlePreLoadMapForPrefetch(const FWorldContext& WorldContext, const FString& MapName);
+	void HandlePostGarbageCollectForPrefetch();
+
+public:
+	/**
+	 * Loads the widget class of the loading type in the background ahead of its use
+	 * 
+	 * Tip:
+	 *	Call this when a transition is about to start so that the widget of a released class can be shown without a hitch.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Loading Screen", meta = (GameplayTagFilter = "LoadingType"))
+	void PrefetchLoadingWidget(FGameplayTag LoadingTypeTag);
+
+	/**
+	 * Loads the widget classes of all loading types with the PreloadBeforeUse policy in the background
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Loading Screen")
+	void PrefetchPredictedLoadingWidgets();
+
+
+	////////////////////////////////////////////////////////
+	// Loading Processes Infos
+public:
+	//
+	// Mapping list of handles with information on ongoing loading process
+	//
+	UPROPERTY(Transient)
+	TMap<FGameplayTag, FLoadingScreenInfo> LoadingScreenInfos;
+
+public:
+	/**
+	 * Loading screen notifies the start of the required loading process
+	 * 
+	 * !!!Note!!!:
+	 *	Be sure to save the Handle and delete it using RemoveLoadingProcess() when the process is finished. 
+	 *	Otherwise, the loading widget will remain.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Loading Screen", meta = (GameplayTagFilter = "LoadingType"))
+	bool AddLoadingProcess(FName ProcessName, FGameplayTag LoadingTypeTag, FText Reason);
+
+	/**
+	 * Notifies the end of the loading process
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Loading Screen")
+	bool RemoveLoadingProcess(FName ProcessName);
+
+	/**
+	 * Notifies the end of the loading process using tag
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Loading Screen", meta = (GameplayTagFilter = "LoadingType"))
+	bool RemoveLoadingProcessByTag(FGameplayTag LoadingTypeTag);
+
+protected:
+	virtual bool AddLoadingProcessExistType(FLoadingScreenInfo& Info, FName ProcessName, const FGameplayTag& LoadingTypeTag, const FText& Reason);
+	virtual bool AddLoadingProcessNew(FName ProcessName, const FGameplayTag& LoadingTypeTag, const FText& Reason, int32 TypeIndex);
+
+public:
+	/**
+	 * Get loading reason from handle
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Loading Screen")
+	virtual const FText& GetLoadingReasonFromName(FName ProcessName) const;
+
+	/**
+	 * Get loading reasons from tag
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Loading Screen", meta = (GameplayTagFilter = "LoadingType"))
+	virtual TArray<FText> GetLoadingReasonsFromTag(FGameplayTag LoadingTypeTag) const;
+
+	/**
+	 * Get copies of the loading processes from tag
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Loading Screen", meta = (GameplayTagFilter = "LoadingType"))
+	TArray<FLoadingProcessEntry> GetLoadingProcessesFromTag(FGameplayTag LoadingTypeTag) const;
+
+	/**
+	 * Visits the loading process names and reasons of the tag without copying them
+	 */
+	void ForEachLoadingReason(const FGameplayTag& LoadingTypeTag, TFunctionRef<void(FName, const FText&)> Func) const;
+
+	/**
+	 * Changes the reason of the ongoing loading process
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Loading Screen")
+	bool SetLoadingProcessReason(FName ProcessName, FText NewReason);
+
+
+	////////////////////////////////////////////////////////
+	// Loading Process Notification
+public:
+	//
+	// Delegate notifies you that the loading process of any loading type has been changed
+	//
+	UPROPERTY(BlueprintAssignable, Category = "Loading Screen")
+	FLoadingProcessChangedDynamicDelegate OnLoadingProcessChanged;
+
+protected:
+	//
+	// Mapping list of loading type tags and delegates notifying changes to their loading processes
+	//
+	TMap<FGameplayTag, FLoadingProcessChangedDelegate> LoadingProcessChangedDelegates;
+
+public:
+	/**
+	 * Returns the delegate notifying changes to the loading process of the loading type
+	 * 
+	 * Tip:
+	 *	Loading widgets can rebuild the reason text only when notified instead of polling GetLoadingReasonsFromTag() every frame.
+	 */
+	FLoadingProcessChangedDelegate& OnLoadingProcessChangedForTag(const FGameplayTag& LoadingTypeTag) { return LoadingProcessChangedDelegates.FindOrAdd(LoadingTypeTag); }
+
+protected:
+	void NotifyLoadingProcessChanged(const FGameplayTag& LoadingTypeTag, FName ProcessName, ELoadingProcessChangeType ChangeType);
+	void NotifyAllLoadingProcessesRemoved(const FGameplayTag& LoadingTypeTag, const FLoadingScreenInfo& Info);
+
+
+	////////////////////////////////////////////////////////
+	// Loading Process Batch
+protected:
+	//
+	// Number of times the open batches were discarded, so that scoped batches opened before that do not close newer ones
+	//
+	int32 LoadingProcessBatchEpoch{ 0 };
+
+public:
+	/**
+	 * Starts collecting the addition and removal of loading processes.
+	 *
+	 * Tip:
+	 *	Changes are applied in one pass by EndLoadingProcessBatch() and the loading widgets are evaluated only once.
+	 *	Batches can be nested, and only the outermost EndLoadingProcessBatch() applies the changes.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Loading Screen")
+	void BeginLoadingProcessBatch();
+
+	/**
+	 * Applies the addition and removal of loading processes collected since BeginLoadingProcessBatch()
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Loading Screen")
+	void EndLoadingProcessBatch();
+
+	/**
+	 * Returns whether a loading process batch is currently open or not
+	 */
+	bool IsLoadingProcessBatchOpen() const { return Core.IsBatchOpen(); }
+
+	int32 GetLoadingProcessBatchEpoch() const { return LoadingProcessBatchEpoch; }
+
+
+	////////////////////////////////////////////////////////
+	// Loading History
+public:
+	FLoadingSlowerThanHistoryDelegate OnLoadingSlowerThanHistory;
+
+protected:
+	//
+	// Database of loading durations per map and loading type
+	//
+	FLoadingHistoryDatabase LoadingHistory;
+
+	//
+	// Name of the map that is currently loaded or being loaded
+	//
+	UPROPERTY(Transient)
+	FName LoadingHistoryMapName{ NAME_None };
+
+protected:
+	void InitializeLoadingHistory();
+	void DeinitializeLoadingHistory();
+
+	FString GetLoadingHistoryFilePath() const;
+
+	void HandlePreLoadMapForHistory(const FWorldContext& WorldContext, const FString& MapName);
+	void HandlePostLoadMapForHistory(UWorld* World);
+
+	void RecordLoadingHistory(const FGameplayTag& LoadingTypeTag, FName ProcessName, float Duration);
+
+	float GetExpectedDuration(const FGameplayTag& LoadingTypeTag, FName ProcessName) const;
+	void RefreshExpectedDurations();
+
+public:
+	/**
+	 * Returns the estimated number of seconds until the loading type finishes, based on its history.
+	 * Returns a negative value if there is no history.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Loading Screen", meta = (GameplayTagFilter = "LoadingType"))
+	float GetEstimatedLoadingTimeRemaining(FGameplayTag LoadingTypeTag) const;
+
+	/**
+	 * Returns the estimated number of seconds until the loading process finishes, based on its history.
+	 * Returns a negative value if there is no history.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Loading Screen")
+	float GetEstimatedProcessTimeRemaining(FName ProcessName) const;
+
+	/**
+	 * Returns the estimated progress (0.0 - 1.0) of the loading type, based on its history.
+	 * Returns a negative value if there is no history.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Loading Screen", meta = (GameplayTagFilter = "LoadingType"))
+	float GetEstimatedLoadingProgress(FGameplayTag LoadingTypeTag) const;
+
+
+	////////////////////////////////////////////////////////
+	// Hitch Detection
+protected:
+	//
+	// Detector of frames over the threshold while the loading screen is displayed
+	//
+	FLoadingScreenHitchDetector HitchDetector;
+
+protected:
+	void SampleLoadingScreenFrame(float FrameSecs);
+
+
+	////////////////////////////////////////////////////////
+	// Memory Tracking
+protected:
+	//
+	// Tracker of memory high-water marks for each loading screen transition
+	//
+	FLoadingMemoryTracker MemoryTracker;
+
+public:
+	/**
+	 * Returns the memory usage recorded at show, peak and hide for recent loading screen transitions
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Loading Screen")
+	FString GetMemoryReport() const;
+
+
+	////////////////////////////////////////////////////////
+	// Watchdog
+protected:
+	//
+	// Interval in seconds at which the watchdog checks the loading processes
+	//
+	static constexpr double WatchdogCheckIntervalSecs{ 1.0 };
+
+	//
+	// Number of seconds after which a single loading process is treated as stalled (0 if disabled)
+	//
+	float LoadingProcessTimeoutSecs{ 0.0f };
+
+	//
+	// Time at which the watchdog checks the loading processes next
+	//
+	double NextWatchdogCheckTime{ 0.0 };
+
+	//
+	// Names of the stalled loading processes that have already been reported
+	//
+	TSet<FName> WatchdogReportedProcesses;
+
+	//
+	// Bits of the stalled loading types that have already been reported
+	//
+	TBitArray<> WatchdogReportedTypes;
+
+	//
+	// Thread that dumps the game thread call stack when the earliest deadline passes, even if the game thread is blocked
+	//
+	FLoadingWatchdogThread WatchdogThread;
+
+	//
+	// Loading time of the deadline last passed to WatchdogThread (0 if none)
+	//
+	double WatchdogThreadDeadline{ 0.0 };
+
+protected:
+	/**
+	 * Checks for loading processes and loading types that exceed their timeout, reports them and optionally removes them
+	 */
+	void TickWatchdog(double CurrentTime);
+
+	/**
+	 * Passes the earliest deadline of the loading that is not yet reported to WatchdogThread
+	 */
+	void UpdateWatchdogThreadDeadline(double Deadline, double CurrentTime, const FString& Cause);
+
+	/**
+	 * Dumps the active loading processes and the async loading state to the log
+	 */
+	void DumpStalledLoadingReport(const FString& Cause) const;
+
+
+	////////////////////////////////////////////////////////
+	// Event Recording
+protected:
+	//
+	// Recorder of loading process changes, observer decisions and loading widget show/hide
+	//
+	FLoadingEventRecorder EventRecorder;
+
+	//
+	// Whether the loading observers are currently applying their decisions
+	//
+	bool bDispatchingObservers{ false };
+
+protected:
+	void RecordLoadingEvent(ELoadingRecordedEventType Type, FName LoadingTypeName, FName ProcessName = NAME_None, const FText& Reason = FText::GetEmpty(), bool bVisible = false);
+
+public:
+	/**
+	 * Starts recording the loading events of this subsystem
+	 * 
+	 * Tip:
+	 *	Ongoing loading processes are recorded as added at the start, so that the replay starts from the same state.
+	 */
+	bool StartEventRecording();
+
+	/**
+	 * Stops recording and saves the recorded loading events to the file
+	 */
+	bool StopEventRecording(const FString& FilePath);
+
+	bool IsRecordingEvents() const { return EventRecorder.IsRecording(); }
+
+
+	////////////////////////////////////////////////////////
+	// Event Replay
+protected:
+	//
+	// List of recorded events being replayed
+	//
+	TArray<FLoadingRecordedEvent> ReplayEvents;
+
+	//
+	// Index of the next input event to feed into the subsystem
+	//
+	int32 ReplayInputIndex{ 0 };
+
+	//
+	// Index of the next recorded visibility change to compare with
+	//
+	int32 ReplayVisibilityIndex{ 0 };
+
+	//
+	// Number of loading process batches opened by the replay
+	//
+	int32 ReplayBatchDepth{ 0 };
+
+	//
+	// Real time at which the replay started
+	//
+	double ReplayStartTime{ 0.0 };
+
+	//
+	// Speed at which the recorded time advances compared to the real time
+	//
+	double ReplaySpeed{ 1.0 };
+
+	//
+	// Result of the current or last replay
+	//
+	FLoadingEventReplayResult ReplayResult;
+
+	//
+	// Whether a recording is currently being replayed
+	//
+	bool bReplayingEvents{ false };
+
+	//
+	// Whether a recorded event is currently being fed into this subsystem
+	//
+	bool bApplyingReplayedEvent{ false };
+
+	//
+	// Flags restored when the replay finishes
+	//
+	bool bHeadlessBeforeReplay{ false };
+	bool bForceTickLoadingScreenBeforeReplay{ false };
+
+protected:
+	void TickEventReplay();
+	void ApplyReplayedEvent(const FLoadingRecordedEvent& Event);
+	void CheckReplayedVisibility(bool bVisible);
+
+	bool IsEventReplayComplete() const;
+	void FinishEventReplay();
+
+	/**
+	 * Returns whether loading input from the game should be ignored because a recording is being replayed
+	 */
+	bool ShouldIgnoreLiveLoadingInput(FName ProcessName) const;
+
+public:
+	/**
+	 * Feeds the recorded loading events back into this subsystem in headless mode and compares the visibility decisions
+	 * 
+	 * Tip:
+	 *	A speed above 1.0 replays the recording faster than it was recorded.
+	 *	Loading observers are not ticked while replaying.
+	 *	Loading processes added or removed by the game while replaying are ignored,
+	 *	and the replay does not change the rendering, input or performance state or notify any listeners.
+	 */
+	bool StartEventReplay(const FString& FilePath, float Speed = 1.0f);
+
+	/**
+	 * Stops feeding the recorded loading events and finishes the replay once the remaining loading is removed
+	 */
+	void StopEventReplay();
+
+	bool IsReplayingEvents() const { return bReplayingEvents; }
+	const FLoadingEventReplayResult& GetEventReplayResult() const { return ReplayResult; }
+
+
+	////////////////////////////////////////////////////////
+	// Loading Screen Core
+protected:
+	//
+	// State machine of the loading types, which this subsystem feeds and applies the side effects of
+	//
+	FLoadingScreenCore Core{ *this, *this };
+
+protected:
+	FLoadingScreenCoreTypeSettings MakeCoreTypeSettings(const FLoadingScreenDefinition& Def) const;
+
+	/**
+	 * Returns the current time used for loading, which advances at the replay speed while replaying
+	 */
+	virtual double GetLoadingTime() const override;
+
+	virtual bool CanShowLoadingTypeImmediately(int32 TypeIndex) const override;
+	virtual void HandleLoadingTypeShown(int32 TypeIndex) override;
+	virtual void HandleLoadingTypeHidden(int32 TypeIndex) override;
+	virtual void HandleLoadingTypeSuppressed(int32 TypeIndex) override;
+	virtual void HandleLoadingTypesFinished(TConstArrayView<FLoadingScreenCoreFinishedType> FinishedTypes) override;
+	virtual void HandleLoadingTypeDiscarded(int32 TypeIndex) override;
+	virtual void HandleInputBlockChanged(bool bBlocked) override { UpdateInputBlock(); }
+	virtual void HandleSavingPerformanceChanged(bool bSaving) override { UpdatePerformance(); }
+
+
+	////////////////////////////////////////////////////////
+	// Loading Widgets
+public:
+	FLoadingScreenVisibilityChangedDelegate OnLoadingScreenVisibilityChanged;
+
+protected:
+	//
+	// Mapping list of loading widgets and their tags currently displayed
+	//
+	TMap<FGameplayTag, FLoadingScreenShowingWidget> ShowingWidgets;
+
+	//
+	// Whether the widgets in ShowingWidgets have changed and their composition needs to be updated
+	//
+	bool bShowingWidgetsDirty{ false };
+
+	//
+	// Number of widgets in ShowingWidgets that are kept displayed and waiting to be reused
+	//
+	int32 NumLingeringWidgets{ 0 };
+
+	//
+	// Whether the loading screen is currently displayed or not
+	//
+	UPROPERTY(Transient)
+	bool bLoadingWidgetDisplayed{ false };
+
+protected:
+	void UpdateLoadingWidgets();
+
+	void TryCreateLoadingWidget(const FGameplayTag& Tag, const TSubclassOf<UUserWidget>& Class, const int32& ZOrder, const FLoadingScreenDefinition& Def);
+	void TryRemoveLoadingWidget(const FGameplayTag& Tag);
+	void DestroyLoadingWidget(const FGameplayTag& Tag);
+	void RemoveAllWidgets();
+
+public:
+	/**
+	 * Wraps the slate widget of a loading widget in the panel of the render mode of the definition
+	 */
+	static TSharedRef<SWidget> WrapLoadingWidget(const TSharedRef<SWidget>& SlateWidget, const FLoadingScreenDefinition& Def);
+
+protected:
+	/**
+	 * Removes the lingering widgets whose reuse grace window has expired from the viewport
+	 */
+	void ExpireLingeringWidgets(double CurrentTime);
+
+	/**
+	 * Returns whether any widget in ShowingWidgets is displayed, including the ones waiting to be reused
+	 */
+	bool HasDisplayedLoadingWidget() const;
+
+	/**
+	 * Collapses the widgets covered by the top most opaque fullscreen widget and restores the others
+	 */
+	void UpdateWidgetOcclusion();
+
+	/**
+	 * Returns whether or not the initialization load screen is being displayed before the normal load screen.
+	 */
+	bool IsShowingInitialLoadingScreen() const;
+
+public:
+	/**
+	 * Get loading reasons from tag
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Loading Screen")
+	virtual bool IsLoadingWidgetDisplayed() const { return bLoadingWidgetDisplayed; }
+
+	/**
+	 * Returns the number of loading widgets that were never displayed because the loading ended within their show delay
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Loading Screen")
+	int32 GetNumSuppressedLoadingScreens() const { return Core.GetNumSuppressedShows(); }
+
+
+	////////////////////////////////////////////////////////
+	// Input
+protected:
+	//
+	// Whether the input is currently blocked or not
+	//
+	UPROPERTY(Transient)
+	bool bInputBlocked{ false };
+
+protected:
+	virtual void UpdateInputBlock();
+
+	
+	////////////////////////////////////////////////////////
+	// Performace
+protected:
+	//
+	// Whether the peformance is currently saved or not
+	//
+	UPROPERTY(Transient)
+	bool bSavingPerformance{ false };
+
+protected:
+	virtual void UpdatePerformance();
+
+
+	////////////////////////////////////////////////////////
+	// Presentation Rate
+protected:
+	//
+	// Presentation rate currently applied by the loading screen (0 if not limited)
+	//
+	float AppliedPresentationRate{ 0.0f };
+
+	//
+	// Time and frame number at which the presentation rate was limited
+	//
+	double PresentationRateStartTime{ 0.0 };
+	uint64 PresentationRateStartFrame{ 0 };
+
+protected:
+	/**
+	 * Requests the lowest target presentation rate of the displayed widgets from the global state arbiter
+	 */
+	void UpdatePresentationRate();
+
+	void ApplyPresentationRate(float Rate);
+	void RestorePresentationRate();
+
+};
+
+
+/**
+ * Scope object that batches the addition and removal of loading processes while it is alive
+ */
+struct FScopedLoadingProcessBatch
+{
+public:
+	explicit FScopedLoadingProcessBatch(ULoadingScreenSubsystem* InSubsystem)
+		: Subsystem(InSubsystem)
+	{
+		if (Subsystem.IsValid())
+		{
+			BatchEpoch = Subsystem->GetLoadingProcessBatchEpoch();
+
+			Subsystem->BeginLoadingProcessBatch();
+		}
+	}
+
+	~FScopedLoadingProcessBatch()
+	{
+		// The batch has already been discarded if the subsystem was deinitialized while this scope was alive
+
+		if (Subsystem.IsValid() && (Subsystem->GetLoadingProcessBatchEpoch() == BatchEpoch))
+		{
+			Subsystem->EndLoadingProcessBatch();
+		}
+	}
+
+	UE_NONCOPYABLE(FScopedLoadingProcessBatch);
+
+private:
+	TWeakObjectPtr<ULoadingScreenSubsystem> Subsystem;
 
-	void IncrementSavingPerformanceCount() { SavingPerformanceCount++; UpdatePerformance(); }
-	void DecrementSavingPerformanceCount() { SavingPerformanceCount--; UpdatePerformance(); }
-	void ClearSavingPerformanceCount() { SavingPerformanceCount = 0; UpdatePerformance(); }
+	int32 BatchEpoch{ 0 };
 
 };
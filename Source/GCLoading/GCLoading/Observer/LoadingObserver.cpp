@@ -2,6 +2,10 @@
 
 #include "LoadingObserver.h"
 
+#include "GCLoadingStats.h"
+
+#include "Async/ParallelFor.h"
+
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LoadingObserver)
 
 
@@ -19,6 +23,10 @@ void ULoadingObserver::InitializeObserver(UGameInstance* GameInstance, ULoadingS
 	OwnerGameInstance = GameInstance;
 	OwnerSubsystem = Subsystem;
 
+#if STATS
+	TickStatId = FDynamicStats::CreateStatId<FStatGroup_STATGROUP_GCLoading>(GetClass()->GetName());
+#endif
+
 	OnInitialized();
 }
 
@@ -26,3 +34,122 @@ void ULoadingObserver::DeinitializeObserver()
 {
 	OnDeinitialize();
 }
+
+
+bool ULoadingObserver::UpdateTickDue(float DeltaTime, bool bLoadingScreenVisible)
+{
+	// Accumulate the game time so that observers that are not ticked every frame receive the time since their last tick
+
+	PendingDeltaTime += DeltaTime;
+
+	switch (TickPolicy)
+	{
+	case ELoadingObserverTickPolicy::EveryFrame:
+		return true;
+
+	case ELoadingObserverTickPolicy::Interval:
+		return PendingDeltaTime >= TickInterval;
+
+	case ELoadingObserverTickPolicy::WhileLoadingScreenVisible:
+		{
+			if (!bLoadingScreenVisible)
+			{
+				PendingDeltaTime = 0.0f;
+			}
+
+			return bLoadingScreenVisible;
+		}
+
+	default:
+		{
+			PendingDeltaTime = 0.0f;
+			return false;
+		}
+	}
+}
+
+void ULoadingObserver::DispatchTick()
+{
+	if (IsEvaluationThreadSafe())
+	{
+		DispatchEvaluation();
+		DispatchApply();
+		return;
+	}
+
+#if STATS
+	FScopeCycleCounter CycleCounter(TickStatId);
+#endif
+
+	Tick(ConsumeDeltaTime());
+}
+
+void ULoadingObserver::DispatchEvaluation()
+{
+#if STATS
+	FScopeCycleCounter CycleCounter(TickStatId);
+#endif
+
+	EvaluateThreadSafe(ConsumeDeltaTime());
+}
+
+void ULoadingObserver::DispatchApply()
+{
+	check(IsInGameThread());
+
+#if STATS
+	FScopeCycleCounter CycleCounter(TickStatId);
+#endif
+
+	ApplyEvaluation();
+}
+
+void ULoadingObserver::DispatchObservers(TArrayView<ULoadingObserver* const> Observers, bool bEvaluateInParallel)
+{
+	TArray<ULoadingObserver*, TInlineAllocator<8>> ThreadSafeObservers;
+
+	if (bEvaluateInParallel)
+	{
+		for (auto* Observer : Observers)
+		{
+			if (Observer->IsEvaluationThreadSafe())
+			{
+				ThreadSafeObservers.Add(Observer);
+			}
+		}
+	}
+
+	const auto bParallel{ ThreadSafeObservers.Num() > 1 };
+
+	if (bParallel)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GCLoading_EvaluateObserversInParallel);
+
+		ParallelFor(ThreadSafeObservers.Num(),
+			[&ThreadSafeObservers](int32 Index)
+			{
+				ThreadSafeObservers[Index]->DispatchEvaluation();
+			});
+	}
+
+	for (auto* Observer : Observers)
+	{
+		if (bParallel && Observer->IsEvaluationThreadSafe())
+		{
+			Observer->DispatchApply();
+		}
+		else
+		{
+			Observer->DispatchTick();
+		}
+	}
+}
+
+float ULoadingObserver::ConsumeDeltaTime()
+{
+	const auto ObserverDeltaTime{ PendingDeltaTime };
+
+	PendingDeltaTime = 0.0f;
+
+	return ObserverDeltaTime;
+}
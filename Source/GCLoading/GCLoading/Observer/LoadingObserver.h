@@ -3,6 +3,7 @@
 #pragma once
 
 #include "UObject/Object.h"
+#include "Stats/Stats.h"
 
 #include "LoadingObserver.generated.h"
 
@@ -10,11 +11,31 @@ class UGameInstance;
 class ULoadingScreenSubsystem;
 
 
+/**
+ * When the loading observer is ticked by the loading screen subsystem
+ */
+UENUM(BlueprintType)
+enum class ELoadingObserverTickPolicy : uint8
+{
+	// Ticked every frame
+	EveryFrame,
+
+	// Ticked at a fixed interval
+	Interval,
+
+	// Ticked every frame only while the loading screen is displayed
+	WhileLoadingScreenVisible,
+
+	// Never ticked, the observer is driven only by events
+	Never
+};
+
+
 /**
  * Base class for monitoring the processing of the possibility that the loading screen needs to be displayed 
  * and automatically showing and hiding the loading screen
  */
-UCLASS(Abstract)
+UCLASS(Abstract, Config = "Game")
 class GCLOADING_API ULoadingObserver : public UObject
 {
 	GENERATED_BODY()
@@ -36,7 +57,98 @@ protected:
 	virtual void OnInitialized() {}
 	virtual void OnDeinitialize() {}
 
+
+protected:
+	//
+	// When the observer is ticked
+	// 
+	// Tip:
+	//	Observers that only react to events should use Never so that they are not dispatched every frame.
+	//
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Tick")
+	ELoadingObserverTickPolicy TickPolicy{ ELoadingObserverTickPolicy::EveryFrame };
+
+	//
+	// Number of seconds between ticks when the tick policy is Interval
+	//
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Tick", meta = (ClampMin = 0.00, Units = "Seconds", EditCondition = "TickPolicy == ELoadingObserverTickPolicy::Interval"))
+	float TickInterval{ 0.25f };
+
+	//
+	// Game time accumulated since the observer was last ticked
+	//
+	float PendingDeltaTime{ 0.0f };
+
+#if STATS
+	//
+	// Stat that counts the tick cost of this observer
+	//
+	TStatId TickStatId;
+#endif
+
 public:
+	/**
+	 * Accumulates the game time of the frame and returns whether the observer should be ticked in the current frame
+	 * 
+	 * Tip:
+	 *	Time that passes while a WhileLoadingScreenVisible observer is not due is discarded,
+	 *	so the first tick after the loading screen reappears does not receive the whole hidden period.
+	 */
+	bool UpdateTickDue(float DeltaTime, bool bLoadingScreenVisible);
+
+	/**
+	 * Ticks the observer with the game time since its last tick and counts its cost
+	 * 
+	 * Tip:
+	 *	Thread-safe observers are evaluated and then applied in sequence.
+	 */
+	void DispatchTick();
+
+	/**
+	 * Evaluates the thread-safe observer with the game time since its last tick and counts its cost.
+	 * 
+	 * !!!Note!!!:
+	 *	May be called from a task graph worker.
+	 */
+	void DispatchEvaluation();
+
+	/**
+	 * Applies the result of the last evaluation on the game thread
+	 */
+	void DispatchApply();
+
+	/**
+	 * Ticks the due observers, evaluating the thread-safe ones in parallel when there is more than one to share the work
+	 * 
+	 * Tip:
+	 *	The decisions are applied on the game thread in the order of the observers to keep the result deterministic.
+	 */
+	static void DispatchObservers(TArrayView<ULoadingObserver* const> Observers, bool bEvaluateInParallel);
+
+	ELoadingObserverTickPolicy GetTickPolicy() const { return TickPolicy; }
+
+	/**
+	 * Returns whether the evaluation of this observer can run off the game thread
+	 */
+	virtual bool IsEvaluationThreadSafe() const { return false; }
+
+protected:
+	float ConsumeDeltaTime();
+
 	virtual void Tick(float DeltaTime) {}
 
+	/**
+	 * Reads the engine state and stores the show or hide decision in the observer.
+	 * 
+	 * !!!Note!!!:
+	 *	Called off the game thread when IsEvaluationThreadSafe() returns true.
+	 *	Must not change the subsystem or any state shared with the game thread.
+	 */
+	virtual void EvaluateThreadSafe(float DeltaTime) {}
+
+	/**
+	 * Applies the decision stored by EvaluateThreadSafe() to the subsystem on the game thread
+	 */
+	virtual void ApplyEvaluation() {}
+
 };
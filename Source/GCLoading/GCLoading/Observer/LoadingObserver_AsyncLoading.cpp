@@ -0,0 +1,254 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "LoadingObserver_AsyncLoading.h"
+
+#include "GameplayTag/GCLoadingTags_LoadingType.h"
+#include "LoadingScreenSubsystem.h"
+#include "GCLoadingLogs.h"
+
+#include "Misc/CoreDelegates.h"
+#include "Misc/StringBuilder.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LoadingObserver_AsyncLoading)
+
+
+#define LOCTEXT_NAMESPACE "LoadingScreen"
+
+const FName ULoadingObserver_AsyncLoading::NAME_AsyncLoadingProcess("AsyncLoadingProcess");
+
+ULoadingObserver_AsyncLoading::ULoadingObserver_AsyncLoading(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	LoadingTypeTag = TAG_LoadingType_Overlay;
+	LoadingReasonFormat = FText(LOCTEXT("AsyncLoadingReason", "Loading Assets ({Percent}%)"));
+}
+
+
+void ULoadingObserver_AsyncLoading::OnInitialized()
+{
+	FCoreUObjectDelegates::OnEndLoadPackage.AddUObject(this, &ThisClass::HandleEndLoadPackage);
+	FCoreDelegates::OnAsyncLoadingFlushUpdate.AddUObject(this, &ThisClass::HandleAsyncLoadingFlushUpdate);
+	FCoreDelegates::OnSyncLoadPackage.AddUObject(this, &ThisClass::HandleSyncLoadPackage);
+}
+
+void ULoadingObserver_AsyncLoading::OnDeinitialize()
+{
+	FCoreUObjectDelegates::OnEndLoadPackage.RemoveAll(this);
+	FCoreDelegates::OnAsyncLoadingFlushUpdate.RemoveAll(this);
+	FCoreDelegates::OnSyncLoadPackage.RemoveAll(this);
+
+	HideLoadingScreen();
+}
+
+void ULoadingObserver_AsyncLoading::EvaluateThreadSafe(float DeltaTime)
+{
+	EvaluatedQueueDepth = GetNumAsyncPackages();
+}
+
+void ULoadingObserver_AsyncLoading::ApplyEvaluation()
+{
+	if (!OwnerSubsystem.IsValid())
+	{
+		return;
+	}
+
+	const auto CurrentTime{ FPlatformTime::Seconds() };
+
+	// Report the flush that blocked the game thread since the last tick
+
+	if (FlushStartTime > 0.0)
+	{
+		const auto FlushDuration{ FlushLastUpdateTime - FlushStartTime };
+
+		if (FlushDuration >= StallSecs)
+		{
+			ReportStall(TEXT("Flush"), FlushDuration, FlushPeakQueueDepth);
+		}
+
+		FlushStartTime = 0.0;
+
+		if (!bShowingLoadingScreen)
+		{
+			NumLoadedPackages = 0;
+			LoadedPackageNames.Reset();
+		}
+	}
+
+	// Display the loading screen while the queue stays deeper than the threshold
+
+	const auto QueueDepth{ EvaluatedQueueDepth };
+
+	if (QueueDepth > QueueDepthThreshold)
+	{
+		if (DeepQueueStartTime <= 0.0)
+		{
+			DeepQueueStartTime = CurrentTime;
+		}
+		else if (!bShowingLoadingScreen && ((CurrentTime - DeepQueueStartTime) >= StallSecs))
+		{
+			ShowLoadingScreen(QueueDepth);
+		}
+	}
+	else
+	{
+		if (bShowingLoadingScreen)
+		{
+			ReportStall(TEXT("Queue"), CurrentTime - DeepQueueStartTime, PeakQueueDepth);
+
+			HideLoadingScreen();
+		}
+
+		DeepQueueStartTime = 0.0;
+	}
+
+	// Report the queue depth as progress
+
+	if (bShowingLoadingScreen)
+	{
+		UpdateLoadingReason(QueueDepth);
+	}
+}
+
+
+void ULoadingObserver_AsyncLoading::HandleEndLoadPackage(const FEndLoadPackageContext& Context)
+{
+	if (IsRecordingPackages())
+	{
+		for (const auto* Package : Context.LoadedPackages)
+		{
+			if (Package)
+			{
+				RecordLoadedPackage(Package->GetFName());
+			}
+		}
+	}
+}
+
+void ULoadingObserver_AsyncLoading::HandleAsyncLoadingFlushUpdate()
+{
+	const auto CurrentTime{ FPlatformTime::Seconds() };
+
+	if (FlushStartTime <= 0.0)
+	{
+		FlushStartTime = CurrentTime;
+		FlushPeakQueueDepth = 0;
+	}
+
+	FlushLastUpdateTime = CurrentTime;
+	FlushPeakQueueDepth = FMath::Max(FlushPeakQueueDepth, GetNumAsyncPackages());
+}
+
+void ULoadingObserver_AsyncLoading::HandleSyncLoadPackage(const FString& PackageName)
+{
+	if (IsRecordingPackages())
+	{
+		RecordLoadedPackage(FName(*PackageName));
+	}
+}
+
+
+void ULoadingObserver_AsyncLoading::ShowLoadingScreen(int32 QueueDepth)
+{
+	PeakQueueDepth = 0;
+	LastReportedQueueDepth = INDEX_NONE;
+
+	// The subsystem rejects a process without reason, so the first progress is the initial reason
+
+	bShowingLoadingScreen = OwnerSubsystem->AddLoadingProcess(NAME_AsyncLoadingProcess, LoadingTypeTag, MakeLoadingReason(QueueDepth));
+
+	if (!bShowingLoadingScreen)
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Failed to display the loading screen for the async loading stall (Type: %s)"), *WriteToString<64>(LoadingTypeTag.GetTagName()));
+
+		// Retry after the stall time instead of every frame
+
+		DeepQueueStartTime = FPlatformTime::Seconds();
+		return;
+	}
+
+	// Keep packages loaded by the flush that started the stall
+
+	if (FlushStartTime <= 0.0)
+	{
+		NumLoadedPackages = 0;
+		LoadedPackageNames.Reset();
+	}
+}
+
+void ULoadingObserver_AsyncLoading::HideLoadingScreen()
+{
+	if (bShowingLoadingScreen)
+	{
+		bShowingLoadingScreen = false;
+
+		NumLoadedPackages = 0;
+		LoadedPackageNames.Reset();
+
+		if (OwnerSubsystem.IsValid())
+		{
+			OwnerSubsystem->RemoveLoadingProcess(NAME_AsyncLoadingProcess);
+		}
+	}
+}
+
+void ULoadingObserver_AsyncLoading::UpdateLoadingReason(int32 QueueDepth)
+{
+	if (LastReportedQueueDepth == QueueDepth)
+	{
+		return;
+	}
+
+	OwnerSubsystem->SetLoadingProcessReason(NAME_AsyncLoadingProcess, MakeLoadingReason(QueueDepth));
+}
+
+FText ULoadingObserver_AsyncLoading::MakeLoadingReason(int32 QueueDepth)
+{
+	LastReportedQueueDepth = QueueDepth;
+	PeakQueueDepth = FMath::Max(PeakQueueDepth, QueueDepth);
+
+	if (LoadingReasonFormat.IsEmpty())
+	{
+		return LOCTEXT("AsyncLoadingDefaultReason", "Loading Assets");
+	}
+
+	const auto Percent{ (PeakQueueDepth > 0) ? ((PeakQueueDepth - QueueDepth) * 100 / PeakQueueDepth) : 0 };
+
+	FFormatNamedArguments Args;
+	Args.Add(TEXT("Remaining"), QueueDepth);
+	Args.Add(TEXT("Percent"), Percent);
+
+	return FText::Format(LoadingReasonFormat, Args);
+}
+
+
+void ULoadingObserver_AsyncLoading::RecordLoadedPackage(FName PackageName)
+{
+	NumLoadedPackages++;
+
+	if (LoadedPackageNames.Num() < MaxRecordedPackages)
+	{
+		LoadedPackageNames.Add(PackageName);
+	}
+}
+
+void ULoadingObserver_AsyncLoading::ReportStall(const TCHAR* Cause, double Duration, int32 PeakDepth)
+{
+	TStringBuilder<1024> PackageNames;
+
+	for (const auto& PackageName : LoadedPackageNames)
+	{
+		PackageNames << TEXT("\n    ") << PackageName;
+	}
+
+	if (NumLoadedPackages > LoadedPackageNames.Num())
+	{
+		PackageNames.Appendf(TEXT("\n    ... and %d more"), NumLoadedPackages - LoadedPackageNames.Num());
+	}
+
+	UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Async loading stall (Cause: %s, Duration: %.3fs, Peak Queue: %d, Loaded Packages: %d)%s"),
+		Cause, Duration, PeakDepth, NumLoadedPackages, PackageNames.ToString());
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,129 @@
+﻿// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Observer/LoadingObserver.h"
+
+#include "GameplayTagContainer.h"
+
+#include "LoadingObserver_AsyncLoading.generated.h"
+
+struct FEndLoadPackageContext;
+
+
+/**
+ * Loading observer class to monitor the async loading queue and flushes of async loading
+ */
+UCLASS(Config = "Game", meta = (DisplayName = "Async Loading Observer"))
+class GCLOADING_API ULoadingObserver_AsyncLoading : public ULoadingObserver
+{
+	GENERATED_BODY()
+public:
+	ULoadingObserver_AsyncLoading(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	static const FName NAME_AsyncLoadingProcess;
+
+	/**
+	 * Number of package names kept for each stall report
+	 */
+	static constexpr int32 MaxRecordedPackages{ 32 };
+
+protected:
+	virtual void OnInitialized() override;
+	virtual void OnDeinitialize() override;
+
+public:
+	virtual bool IsEvaluationThreadSafe() const override { return true; }
+
+protected:
+	virtual void EvaluateThreadSafe(float DeltaTime) override;
+	virtual void ApplyEvaluation() override;
+
+
+protected:
+	//
+	// Loading type displayed while async loading is stalled
+	//
+	UPROPERTY(Config, EditDefaultsOnly, meta = (Categories = "LoadingType"))
+	FGameplayTag LoadingTypeTag;
+
+	//
+	// Number of pending async packages above which the queue is treated as deep
+	//
+	UPROPERTY(Config, EditDefaultsOnly, meta = (ClampMin = 0))
+	int32 QueueDepthThreshold{ 32 };
+
+	//
+	// Number of seconds the queue must stay deep before the loading screen is displayed
+	//
+	UPROPERTY(Config, EditDefaultsOnly, meta = (ClampMin = 0.00, Units = "Seconds"))
+	float StallSecs{ 0.5f };
+
+	//
+	// Reason displayed while async loading is stalled
+	// 
+	// Tip:
+	//	{Remaining} is replaced with the number of pending packages and {Percent} with the progress since the stall started.
+	//	If the format is empty, a default reason is displayed instead.
+	//
+	UPROPERTY(Config, EditDefaultsOnly)
+	FText LoadingReasonFormat;
+
+protected:
+	//
+	// Number of pending async packages read by the last evaluation
+	//
+	int32 EvaluatedQueueDepth{ 0 };
+
+	//
+	// Time at which the queue became deeper than the threshold (0 if not deep)
+	//
+	double DeepQueueStartTime{ 0.0 };
+
+	//
+	// Whether the loading screen is currently displayed for the stall
+	//
+	bool bShowingLoadingScreen{ false };
+
+	//
+	// Deepest queue observed during the current stall
+	//
+	int32 PeakQueueDepth{ 0 };
+
+	//
+	// Queue depth reported by the last reason update
+	//
+	int32 LastReportedQueueDepth{ INDEX_NONE };
+
+	//
+	// Time at which the current flush of async loading started and was last updated (0 if not flushing)
+	//
+	double FlushStartTime{ 0.0 };
+	double FlushLastUpdateTime{ 0.0 };
+
+	//
+	// Deepest queue observed during the current flush of async loading
+	//
+	int32 FlushPeakQueueDepth{ 0 };
+
+	//
+	// Number of packages loaded and the first package names during the current stall or flush
+	//
+	int32 NumLoadedPackages{ 0 };
+	TArray<FName> LoadedPackageNames;
+
+protected:
+	void HandleEndLoadPackage(const FEndLoadPackageContext& Context);
+	void HandleAsyncLoadingFlushUpdate();
+	void HandleSyncLoadPackage(const FString& PackageName);
+
+	void ShowLoadingScreen(int32 QueueDepth);
+	void HideLoadingScreen();
+	void UpdateLoadingReason(int32 QueueDepth);
+	FText MakeLoadingReason(int32 QueueDepth);
+
+	bool IsRecordingPackages() const { return bShowingLoadingScreen || (FlushStartTime > 0.0); }
+	void RecordLoadedPackage(FName PackageName);
+	void ReportStall(const TCHAR* Cause, double Duration, int32 PeakDepth);
+
+};
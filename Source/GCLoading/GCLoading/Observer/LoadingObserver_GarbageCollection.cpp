@@ -0,0 +1,171 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "LoadingObserver_GarbageCollection.h"
+
+#include "GameplayTag/GCLoadingTags_LoadingType.h"
+#include "LoadingScreenSubsystem.h"
+#include "GCLoadingLogs.h"
+
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LoadingObserver_GarbageCollection)
+
+
+#define LOCTEXT_NAMESPACE "LoadingScreen"
+
+const FName ULoadingObserver_GarbageCollection::NAME_GarbageCollectionProcess("GarbageCollectionProcess");
+
+ULoadingObserver_GarbageCollection::ULoadingObserver_GarbageCollection(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	TickPolicy = ELoadingObserverTickPolicy::WhileLoadingScreenVisible;
+
+	LoadingTypeTag = TAG_LoadingType_Fullscreen;
+	GarbageCollectionReason = FText(LOCTEXT("GarbageCollectionReason", "Cleaning Up"));
+}
+
+
+void ULoadingObserver_GarbageCollection::OnInitialized()
+{
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &ThisClass::HandlePreGarbageCollect);
+	FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &ThisClass::HandlePostGarbageCollect);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &ThisClass::HandlePostLoadMap);
+
+	VisibilityChangedHandle = OwnerSubsystem->OnLoadingScreenVisibilityChanged.AddUObject(this, &ThisClass::HandleLoadingScreenVisibilityChanged);
+}
+
+void ULoadingObserver_GarbageCollection::OnDeinitialize()
+{
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().RemoveAll(this);
+	FCoreUObjectDelegates::GetPostGarbageCollect().RemoveAll(this);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
+
+	if (OwnerSubsystem.IsValid())
+	{
+		OwnerSubsystem->OnLoadingScreenVisibilityChanged.Remove(VisibilityChangedHandle);
+	}
+
+	bAwaitingPostLoadPurge = false;
+	bPostLoadGarbageCollectionRequested = false;
+
+	SetHoldingLoadingScreen(false);
+}
+
+void ULoadingObserver_GarbageCollection::Tick(float DeltaTime)
+{
+	if (!OwnerSubsystem.IsValid() || !bAwaitingPostLoadPurge)
+	{
+		return;
+	}
+
+	// Request the garbage collection after map load while the opaque loading screen can still hide it
+
+	if (!bHoldingLoadingScreen)
+	{
+		if (bHoldLoadingScreenForPostLoadPurge && OwnerSubsystem->IsOpaqueLoadingScreenDisplayed())
+		{
+			SetHoldingLoadingScreen(true);
+
+			bPostLoadGarbageCollectionRequested = true;
+			OwnerSubsystem->RequestGarbageCollectionDuringLoadingScreen();
+		}
+		else
+		{
+			bAwaitingPostLoadPurge = false;
+		}
+
+		return;
+	}
+
+	// Keep the loading screen until the requested garbage collection and its purge finish
+
+	const auto bPurgePending{ IsIncrementalPurgePending() || IsIncrementalUnhashPending() };
+
+	if (!bPostLoadGarbageCollectionRequested && !bPurgePending)
+	{
+		bAwaitingPostLoadPurge = false;
+
+		SetHoldingLoadingScreen(false);
+	}
+}
+
+
+void ULoadingObserver_GarbageCollection::HandlePreGarbageCollect()
+{
+	GarbageCollectionStartTime = FPlatformTime::Seconds();
+}
+
+void ULoadingObserver_GarbageCollection::HandlePostGarbageCollect()
+{
+	bPostLoadGarbageCollectionRequested = false;
+
+	if (GarbageCollectionStartTime <= 0.0)
+	{
+		return;
+	}
+
+	const auto CurrentTime{ FPlatformTime::Seconds() };
+	const auto DurationMs{ (CurrentTime - GarbageCollectionStartTime) * 1000.0 };
+
+	GarbageCollectionStartTime = 0.0;
+
+	// Record pauses during transitions and right after them, where they are visible to the player
+
+	if (OwnerSubsystem.IsValid() && OwnerSubsystem->IsLoadingWidgetDisplayed())
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Garbage collection during transition (Time: %.2fms)"), DurationMs);
+	}
+	else if ((LastHideTime > 0.0) && ((CurrentTime - LastHideTime) <= PostTransitionWindowSecs))
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Garbage collection %.2fs after transition (Time: %.2fms)"), CurrentTime - LastHideTime, DurationMs);
+	}
+}
+
+void ULoadingObserver_GarbageCollection::HandlePostLoadMap(UWorld* World)
+{
+	if (World && (World->GetGameInstance() == OwnerGameInstance))
+	{
+		bAwaitingPostLoadPurge = true;
+	}
+}
+
+void ULoadingObserver_GarbageCollection::HandleLoadingScreenVisibilityChanged(bool bVisible)
+{
+	if (!bVisible)
+	{
+		LastHideTime = FPlatformTime::Seconds();
+
+		// The observer is no longer ticked, so the map load can no longer be hidden behind this loading screen
+
+		bAwaitingPostLoadPurge = false;
+		bPostLoadGarbageCollectionRequested = false;
+
+		SetHoldingLoadingScreen(false);
+	}
+}
+
+
+void ULoadingObserver_GarbageCollection::SetHoldingLoadingScreen(bool bNewValue)
+{
+	if (bHoldingLoadingScreen != bNewValue)
+	{
+		bHoldingLoadingScreen = bNewValue;
+
+		if (!OwnerSubsystem.IsValid())
+		{
+			return;
+		}
+
+		if (bHoldingLoadingScreen)
+		{
+			OwnerSubsystem->AddLoadingProcess(NAME_GarbageCollectionProcess, LoadingTypeTag, GarbageCollectionReason);
+		}
+		else
+		{
+			OwnerSubsystem->RemoveLoadingProcess(NAME_GarbageCollectionProcess);
+		}
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
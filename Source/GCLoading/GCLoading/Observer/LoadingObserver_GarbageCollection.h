@@ -0,0 +1,96 @@
+﻿// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Observer/LoadingObserver.h"
+
+#include "GameplayTagContainer.h"
+
+#include "LoadingObserver_GarbageCollection.generated.h"
+
+
+/**
+ * Loading observer class to monitor garbage collection pauses during and right after transitions
+ * and keep the loading screen displayed while the garbage collection after map load is still running
+ */
+UCLASS(Config = "Game", meta = (DisplayName = "Garbage Collection Observer"))
+class GCLOADING_API ULoadingObserver_GarbageCollection : public ULoadingObserver
+{
+	GENERATED_BODY()
+public:
+	ULoadingObserver_GarbageCollection(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	static const FName NAME_GarbageCollectionProcess;
+
+protected:
+	virtual void OnInitialized() override;
+	virtual void OnDeinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+
+
+protected:
+	//
+	// Loading type kept displayed while the garbage collection after map load is running
+	//
+	UPROPERTY(Config, EditDefaultsOnly, meta = (Categories = "LoadingType"))
+	FGameplayTag LoadingTypeTag;
+
+	//
+	// Whether to request a garbage collection after map load and keep the loading screen displayed until it finishes
+	// 
+	// Tip:
+	//	The engine usually purges before the loading screen is hidden, so the garbage collection is requested explicitly
+	//	to run while an opaque fullscreen loading screen hides it from the player.
+	//
+	UPROPERTY(Config, EditDefaultsOnly)
+	bool bHoldLoadingScreenForPostLoadPurge{ true };
+
+	//
+	// Number of seconds after the loading screen is hidden during which garbage collection pauses are still recorded
+	//
+	UPROPERTY(Config, EditDefaultsOnly, meta = (ClampMin = 0.00, Units = "Seconds"))
+	float PostTransitionWindowSecs{ 5.0f };
+
+	//
+	// Reason displayed while the loading screen is kept for garbage collection
+	//
+	UPROPERTY(Config, EditDefaultsOnly)
+	FText GarbageCollectionReason;
+
+protected:
+	//
+	// Time at which the current garbage collection started (0 if not collecting)
+	//
+	double GarbageCollectionStartTime{ 0.0 };
+
+	//
+	// Time at which the loading screen was last hidden
+	//
+	double LastHideTime{ 0.0 };
+
+	//
+	// Whether a map was loaded and its garbage collection has not finished yet
+	//
+	bool bAwaitingPostLoadPurge{ false };
+
+	//
+	// Whether the loading screen is currently kept for garbage collection
+	//
+	bool bHoldingLoadingScreen{ false };
+
+	//
+	// Whether the garbage collection after map load has been requested and has not run yet
+	//
+	bool bPostLoadGarbageCollectionRequested{ false };
+
+	FDelegateHandle VisibilityChangedHandle;
+
+protected:
+	void HandlePreGarbageCollect();
+	void HandlePostGarbageCollect();
+	void HandlePostLoadMap(UWorld* World);
+	void HandleLoadingScreenVisibilityChanged(bool bVisible);
+
+	void SetHoldingLoadingScreen(bool bNewValue);
+
+};
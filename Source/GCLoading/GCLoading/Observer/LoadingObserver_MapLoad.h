@@ -22,8 +22,6 @@ public:
 protected:
 	virtual void OnInitialized() override;
 	virtual void OnDeinitialize() override;
-
-public:
 	virtual void Tick(float DeltaTime) override;
 
 
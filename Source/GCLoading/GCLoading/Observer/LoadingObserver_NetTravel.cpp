@@ -0,0 +1,357 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "LoadingObserver_NetTravel.h"
+
+#include "GameplayTag/GCLoadingTags_LoadingType.h"
+#include "LoadingScreenSubsystem.h"
+#include "GCLoadingLogs.h"
+
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/PendingNetGame.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "GameMapsSettings.h"
+#include "Misc/PackageName.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LoadingObserver_NetTravel)
+
+
+#define LOCTEXT_NAMESPACE "LoadingScreen"
+
+const FName ULoadingObserver_NetTravel::NAME_NetConnectProcess("NetConnectProcess");
+const FName ULoadingObserver_NetTravel::NAME_NetMapLoadProcess("NetMapLoadProcess");
+const FName ULoadingObserver_NetTravel::NAME_NetJoinProcess("NetJoinProcess");
+const FName ULoadingObserver_NetTravel::NAME_NetFirstPawnProcess("NetFirstPawnProcess");
+
+ULoadingObserver_NetTravel::ULoadingObserver_NetTravel(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	LoadingTypeTag = TAG_LoadingType_Fullscreen;
+	ConnectReason = FText(LOCTEXT("NetConnectReason", "Connecting to Server"));
+	MapLoadReason = FText(LOCTEXT("NetMapLoadReason", "Loading World"));
+	JoinReason = FText(LOCTEXT("NetJoinReason", "Joining Server"));
+	FirstPawnReason = FText(LOCTEXT("NetFirstPawnReason", "Waiting for Player"));
+}
+
+
+void ULoadingObserver_NetTravel::OnInitialized()
+{
+	FCoreUObjectDelegates::PreLoadMapWithContext.AddUObject(this, &ThisClass::HandlePreLoadMap);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &ThisClass::HandlePostLoadMap);
+
+	if (OwnerGameInstance.IsValid())
+	{
+		OwnerGameInstance->OnNotifyPreClientTravel().AddUObject(this, &ThisClass::HandlePreClientTravel);
+	}
+
+	if (GEngine)
+	{
+		GEngine->OnNetworkFailure().AddUObject(this, &ThisClass::HandleNetworkFailure);
+		GEngine->OnTravelFailure().AddUObject(this, &ThisClass::HandleTravelFailure);
+	}
+}
+
+void ULoadingObserver_NetTravel::OnDeinitialize()
+{
+	FCoreUObjectDelegates::PreLoadMapWithContext.RemoveAll(this);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
+
+	if (OwnerGameInstance.IsValid())
+	{
+		OwnerGameInstance->OnNotifyPreClientTravel().RemoveAll(this);
+	}
+
+	if (GEngine)
+	{
+		GEngine->OnNetworkFailure().RemoveAll(this);
+		GEngine->OnTravelFailure().RemoveAll(this);
+	}
+
+	SetPhase(ELoadingNetTravelPhase::None);
+}
+
+void ULoadingObserver_NetTravel::Tick(float DeltaTime)
+{
+	if (!OwnerSubsystem.IsValid() || !OwnerGameInstance.IsValid())
+	{
+		return;
+	}
+
+	const auto* Context{ OwnerGameInstance->GetWorldContext() };
+	const auto* PendingNetGame{ Context ? Context->PendingNetGame.Get() : nullptr };
+
+	// Stop tracking a phase that never finishes so that the loading screen does not stay forever
+
+	if ((CurrentPhase != ELoadingNetTravelPhase::None) && (PhaseTimeoutSecs > 0.0f) && ((FPlatformTime::Seconds() - PhaseStartTime) >= PhaseTimeoutSecs))
+	{
+		AbortTravel(TEXT("Timeout"));
+		return;
+	}
+
+	switch (CurrentPhase)
+	{
+	case ELoadingNetTravelPhase::None:
+	case ELoadingNetTravelPhase::FirstPawn:
+		{
+			// A new connection to a server has started
+
+			if (PendingNetGame && !PendingNetGame->bSuccessfullyConnected && (PendingNetGame != IgnoredPendingNetGame.Get()))
+			{
+				SetPhase(ELoadingNetTravelPhase::Connect);
+				break;
+			}
+
+			// Travel is complete when the local player no longer waits for the first replicated pawn
+
+			if (CurrentPhase == ELoadingNetTravelPhase::FirstPawn)
+			{
+				const auto* PlayerController{ OwnerGameInstance->GetFirstLocalPlayerController(Context ? Context->World() : nullptr) };
+
+				if (PlayerController && HasFinishedFirstPawn(PlayerController))
+				{
+					SetPhase(ELoadingNetTravelPhase::None);
+				}
+			}
+		}
+		break;
+
+	case ELoadingNetTravelPhase::Connect:
+		{
+			// The connection failed or was cancelled before the welcome message
+
+			if (!PendingNetGame)
+			{
+				SetPhase(ELoadingNetTravelPhase::None);
+			}
+
+			// The map load of the server starts from HandlePreLoadMap once the welcome message is received
+		}
+		break;
+
+	case ELoadingNetTravelPhase::MapLoad:
+		break;
+
+	case ELoadingNetTravelPhase::Join:
+		{
+			// Joined when the pending net game is finished and the player controller is replicated
+
+			const auto* PlayerController{ OwnerGameInstance->GetFirstLocalPlayerController(Context ? Context->World() : nullptr) };
+
+			if (!PendingNetGame && PlayerController)
+			{
+				SetPhase(HasFinishedFirstPawn(PlayerController) ? ELoadingNetTravelPhase::None : ELoadingNetTravelPhase::FirstPawn);
+			}
+		}
+		break;
+	}
+}
+
+
+void ULoadingObserver_NetTravel::HandlePreClientTravel(const FString& PendingURL, ETravelType TravelType, bool bIsSeamlessTravel)
+{
+	PendingTravelURL = PendingURL;
+}
+
+void ULoadingObserver_NetTravel::HandlePreLoadMap(const FWorldContext& WorldContext, const FString& MapName)
+{
+	if (WorldContext.OwningGameInstance != OwnerGameInstance)
+	{
+		return;
+	}
+
+	// Loading the map of the server after connecting, or following the server travel as a client
+
+	if (IsTravellingToServer(WorldContext, MapName))
+	{
+		SetPhase(ELoadingNetTravelPhase::MapLoad);
+	}
+	else if (CurrentPhase != ELoadingNetTravelPhase::None)
+	{
+		AbortTravel(TEXT("Local map load"));
+	}
+
+	PendingTravelURL.Reset();
+}
+
+void ULoadingObserver_NetTravel::HandlePostLoadMap(UWorld* World)
+{
+	if (World && (World->GetGameInstance() == OwnerGameInstance) && (CurrentPhase == ELoadingNetTravelPhase::MapLoad))
+	{
+		SetPhase(ELoadingNetTravelPhase::Join);
+	}
+}
+
+
+void ULoadingObserver_NetTravel::HandleNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString)
+{
+	const auto* Context{ World ? GEngine->GetWorldContextFromWorld(World) : GEngine->GetWorldContextFromPendingNetGameNetDriver(NetDriver) };
+
+	if (Context && (Context->OwningGameInstance == OwnerGameInstance) && (CurrentPhase != ELoadingNetTravelPhase::None))
+	{
+		AbortTravel(ENetworkFailure::ToString(FailureType));
+	}
+}
+
+void ULoadingObserver_NetTravel::HandleTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& ErrorString)
+{
+	// The world is not known when the travel fails before the map is loaded
+
+	if (!World && !OwnerGameInstance.IsValid())
+	{
+		return;
+	}
+
+	const auto* Context{ World ? GEngine->GetWorldContextFromWorld(World) : OwnerGameInstance->GetWorldContext() };
+
+	if (Context && (Context->OwningGameInstance == OwnerGameInstance) && (CurrentPhase != ELoadingNetTravelPhase::None))
+	{
+		AbortTravel(ETravelFailure::ToString(FailureType));
+	}
+}
+
+
+void ULoadingObserver_NetTravel::AbortTravel(const TCHAR* Cause)
+{
+	UE_LOG(LogGameCore_LoadingScreen, Warning, TEXT("Net travel aborted in phase %s (Cause: %s, Time: %.3fs)"),
+		*UEnum::GetValueAsString(CurrentPhase), Cause, FPlatformTime::Seconds() - PhaseStartTime);
+
+	// Do not start tracking the same failed connection again
+
+	if (const auto* Context{ OwnerGameInstance.IsValid() ? OwnerGameInstance->GetWorldContext() : nullptr })
+	{
+		IgnoredPendingNetGame = Context->PendingNetGame.Get();
+	}
+
+	SetPhase(ELoadingNetTravelPhase::None);
+}
+
+bool ULoadingObserver_NetTravel::IsTravellingToServer(const FWorldContext& WorldContext, const FString& MapName) const
+{
+	if (WorldContext.PendingNetGame)
+	{
+		return true;
+	}
+
+	// Without a pending net game, only a client travel to a map of the server is tracked
+
+	if (PendingTravelURL.IsEmpty())
+	{
+		return false;
+	}
+
+	const FURL URL(nullptr, *PendingTravelURL, TRAVEL_Absolute);
+
+	if (URL.HasOption(TEXT("closed")) || URL.HasOption(TEXT("listen")))
+	{
+		return false;
+	}
+
+	const auto DefaultMapName{ FPackageName::GetShortName(UGameMapsSettings::GetGameDefaultMap()) };
+
+	return !DefaultMapName.Equals(FPackageName::GetShortName(MapName), ESearchCase::IgnoreCase);
+}
+
+bool ULoadingObserver_NetTravel::HasFinishedFirstPawn(const APlayerController* PlayerController) const
+{
+	if (!bWaitForFirstPawn || PlayerController->GetPawn())
+	{
+		return true;
+	}
+
+	// Spectators never receive a pawn
+
+	const auto* PlayerState{ PlayerController->PlayerState.Get() };
+
+	return PlayerState && (PlayerState->IsOnlyASpectator() || PlayerState->IsSpectator());
+}
+
+
+void ULoadingObserver_NetTravel::SetPhase(ELoadingNetTravelPhase NewPhase)
+{
+	if (CurrentPhase == NewPhase)
+	{
+		return;
+	}
+
+	const auto CurrentTime{ FPlatformTime::Seconds() };
+	const auto OldPhase{ CurrentPhase };
+
+	CurrentPhase = NewPhase;
+
+	if (OldPhase == ELoadingNetTravelPhase::None)
+	{
+		TravelStartTime = CurrentTime;
+	}
+	else
+	{
+		UE_LOG(LogGameCore_LoadingScreen, Log, TEXT("Net travel phase %s finished (Time: %.3fs, Since travel start: %.3fs)"),
+			*UEnum::GetValueAsString(OldPhase), CurrentTime - PhaseStartTime, CurrentTime - TravelStartTime);
+	}
+
+	PhaseStartTime = CurrentTime;
+
+	if (!OwnerSubsystem.IsValid())
+	{
+		return;
+	}
+
+	// Add the next phase first so that the loading type is not hidden between phases, and removing the phase records its duration to the history
+
+	FScopedLoadingProcessBatch Batch(OwnerSubsystem.Get());
+
+	if (NewPhase != ELoadingNetTravelPhase::None)
+	{
+		OwnerSubsystem->AddLoadingProcess(GetPhaseProcessName(NewPhase), LoadingTypeTag, GetPhaseReason(NewPhase));
+	}
+
+	if (OldPhase != ELoadingNetTravelPhase::None)
+	{
+		OwnerSubsystem->RemoveLoadingProcess(GetPhaseProcessName(OldPhase));
+	}
+}
+
+FName ULoadingObserver_NetTravel::GetPhaseProcessName(ELoadingNetTravelPhase Phase)
+{
+	switch (Phase)
+	{
+	case ELoadingNetTravelPhase::Connect:
+		return NAME_NetConnectProcess;
+
+	case ELoadingNetTravelPhase::MapLoad:
+		return NAME_NetMapLoadProcess;
+
+	case ELoadingNetTravelPhase::Join:
+		return NAME_NetJoinProcess;
+
+	case ELoadingNetTravelPhase::FirstPawn:
+		return NAME_NetFirstPawnProcess;
+
+	default:
+		return NAME_None;
+	}
+}
+
+const FText& ULoadingObserver_NetTravel::GetPhaseReason(ELoadingNetTravelPhase Phase) const
+{
+	switch (Phase)
+	{
+	case ELoadingNetTravelPhase::Connect:
+		return ConnectReason;
+
+	case ELoadingNetTravelPhase::MapLoad:
+		return MapLoadReason;
+
+	case ELoadingNetTravelPhase::Join:
+		return JoinReason;
+
+	case ELoadingNetTravelPhase::FirstPawn:
+		return FirstPawnReason;
+
+	default:
+		return FText::GetEmpty();
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
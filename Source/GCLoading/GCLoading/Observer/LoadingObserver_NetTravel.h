@@ -0,0 +1,160 @@
+﻿// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Observer/LoadingObserver.h"
+
+#include "GameplayTagContainer.h"
+#include "Engine/EngineBaseTypes.h"
+
+#include "LoadingObserver_NetTravel.generated.h"
+
+struct FWorldContext;
+class UPendingNetGame;
+class UNetDriver;
+class APlayerController;
+
+
+/**
+ * Phases of the travel to a server
+ */
+UENUM(BlueprintType)
+enum class ELoadingNetTravelPhase : uint8
+{
+	// Not travelling to a server
+	None,
+
+	// Connecting to the server until the welcome message is received
+	Connect,
+
+	// Loading the map of the server
+	MapLoad,
+
+	// Joining the server until the player controller is replicated
+	Join,
+
+	// Waiting for the first pawn to be replicated
+	FirstPawn
+};
+
+
+/**
+ * Loading observer class to track each phase of the travel to a server as a separate loading process
+ * 
+ * Tip:
+ *	The duration of each phase is recorded in the loading history in the same way as other loading processes.
+ *	It can be tried locally by playing in editor as a client of a listen server.
+ */
+UCLASS(Config = "Game", meta = (DisplayName = "Net Travel Observer"))
+class GCLOADING_API ULoadingObserver_NetTravel : public ULoadingObserver
+{
+	GENERATED_BODY()
+public:
+	ULoadingObserver_NetTravel(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	static const FName NAME_NetConnectProcess;
+	static const FName NAME_NetMapLoadProcess;
+	static const FName NAME_NetJoinProcess;
+	static const FName NAME_NetFirstPawnProcess;
+
+protected:
+	virtual void OnInitialized() override;
+	virtual void OnDeinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+
+
+protected:
+	//
+	// Loading type displayed during the travel to a server
+	//
+	UPROPERTY(Config, EditDefaultsOnly, meta = (Categories = "LoadingType"))
+	FGameplayTag LoadingTypeTag;
+
+	//
+	// Reasons displayed for each phase
+	//
+	UPROPERTY(Config, EditDefaultsOnly)
+	FText ConnectReason;
+
+	UPROPERTY(Config, EditDefaultsOnly)
+	FText MapLoadReason;
+
+	UPROPERTY(Config, EditDefaultsOnly)
+	FText JoinReason;
+
+	UPROPERTY(Config, EditDefaultsOnly)
+	FText FirstPawnReason;
+
+	//
+	// Whether to wait for the first pawn after joining
+	// 
+	// Tip:
+	//	Disable this for games where players join without a pawn.
+	//	Spectator-only players never wait for a pawn.
+	//
+	UPROPERTY(Config, EditDefaultsOnly)
+	bool bWaitForFirstPawn{ true };
+
+	//
+	// Number of seconds after which a phase is treated as failed and the travel is no longer tracked (0 if disabled)
+	//
+	UPROPERTY(Config, EditDefaultsOnly, meta = (ClampMin = 0.00, Units = "Seconds"))
+	float PhaseTimeoutSecs{ 60.0f };
+
+protected:
+	//
+	// Phase of the travel currently in progress
+	//
+	UPROPERTY(Transient)
+	ELoadingNetTravelPhase CurrentPhase{ ELoadingNetTravelPhase::None };
+
+	//
+	// Time at which the current phase and the whole travel started
+	//
+	double PhaseStartTime{ 0.0 };
+	double TravelStartTime{ 0.0 };
+
+	//
+	// URL of the client travel notified before the next map load
+	//
+	FString PendingTravelURL;
+
+	//
+	// Pending net game whose travel failed or timed out and is no longer tracked
+	//
+	TWeakObjectPtr<UPendingNetGame> IgnoredPendingNetGame;
+
+protected:
+	void HandlePreClientTravel(const FString& PendingURL, ETravelType TravelType, bool bIsSeamlessTravel);
+	void HandlePreLoadMap(const FWorldContext& WorldContext, const FString& MapName);
+	void HandlePostLoadMap(UWorld* World);
+	void HandleNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString);
+	void HandleTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& ErrorString);
+
+	// The automation test drives the handlers directly instead of broadcasting travel events to the whole engine
+	friend class FLoadingObserverNetTravelPhaseTest;
+
+	/**
+	 * Stops tracking the travel because it failed
+	 */
+	void AbortTravel(const TCHAR* Cause);
+
+	/**
+	 * Returns whether the destination of the map load is a server, rather than a local map such as the default map after a disconnect
+	 */
+	bool IsTravellingToServer(const FWorldContext& WorldContext, const FString& MapName) const;
+
+	/**
+	 * Returns whether the player has joined far enough that the travel is complete
+	 */
+	bool HasFinishedFirstPawn(const APlayerController* PlayerController) const;
+
+	void SetPhase(ELoadingNetTravelPhase NewPhase);
+
+	static FName GetPhaseProcessName(ELoadingNetTravelPhase Phase);
+	const FText& GetPhaseReason(ELoadingNetTravelPhase Phase) const;
+
+public:
+	ELoadingNetTravelPhase GetCurrentPhase() const { return CurrentPhase; }
+
+};
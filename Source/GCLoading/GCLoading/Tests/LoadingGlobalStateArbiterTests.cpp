@@ -0,0 +1,269 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LoadingGlobalStateArbiter.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+
+namespace LoadingGlobalStateArbiterTests
+{
+	/**
+	 * Target that records the global states instead of changing the running process
+	 */
+	class FFakeTarget : public ILoadingGlobalStateTarget
+	{
+	public:
+		FFakeTarget()
+		{
+			MaxFPS = IConsoleManager::Get().RegisterConsoleVariable(TEXT("GCLoading.Test.MaxFPS"), 0.0f, TEXT("Fake t.MaxFPS for tests"), ECVF_Default);
+			AsyncLoadingTimeLimit = IConsoleManager::Get().RegisterConsoleVariable(TEXT("GCLoading.Test.AsyncLoadingTimeLimit"), 5.0f, TEXT("Fake s.AsyncLoadingTimeLimit for tests"), ECVF_Default);
+			AsyncLoadingUseFullTimeLimit = IConsoleManager::Get().RegisterConsoleVariable(TEXT("GCLoading.Test.AsyncLoadingUseFullTimeLimit"), 0, TEXT("Fake s.AsyncLoadingUseFullTimeLimit for tests"), ECVF_Default);
+		}
+
+		virtual ~FFakeTarget()
+		{
+			IConsoleManager::Get().UnregisterConsoleObject(MaxFPS, false);
+			IConsoleManager::Get().UnregisterConsoleObject(AsyncLoadingTimeLimit, false);
+			IConsoleManager::Get().UnregisterConsoleObject(AsyncLoadingUseFullTimeLimit, false);
+		}
+
+	public:
+		IConsoleVariable* MaxFPS{ nullptr };
+		IConsoleVariable* AsyncLoadingTimeLimit{ nullptr };
+		IConsoleVariable* AsyncLoadingUseFullTimeLimit{ nullptr };
+
+		bool bSavingPerformance{ false };
+		bool bInputPreProcessorRegistered{ false };
+		bool bSlateInitialized{ true };
+
+		int32 NumInvalidChanges{ 0 };
+
+	public:
+		virtual void SetSavingPerformance(bool bSaving) override
+		{
+			NumInvalidChanges += (bSavingPerformance == bSaving) ? 1 : 0;
+			bSavingPerformance = bSaving;
+		}
+
+		virtual bool RegisterInputPreProcessor() override
+		{
+			NumInvalidChanges += bInputPreProcessorRegistered ? 1 : 0;
+			bInputPreProcessorRegistered = bSlateInitialized;
+
+			return bInputPreProcessorRegistered;
+		}
+
+		virtual void UnregisterInputPreProcessor() override
+		{
+			NumInvalidChanges += bInputPreProcessorRegistered ? 0 : 1;
+			bInputPreProcessorRegistered = false;
+		}
+
+		virtual IConsoleVariable* FindConsoleVariable(const TCHAR* Name) const override
+		{
+			if (FCString::Stricmp(Name, TEXT("t.MaxFPS")) == 0)
+			{
+				return MaxFPS;
+			}
+
+			if (FCString::Stricmp(Name, TEXT("s.AsyncLoadingTimeLimit")) == 0)
+			{
+				return AsyncLoadingTimeLimit;
+			}
+
+			if (FCString::Stricmp(Name, TEXT("s.AsyncLoadingUseFullTimeLimit")) == 0)
+			{
+				return AsyncLoadingUseFullTimeLimit;
+			}
+
+			return nullptr;
+		}
+	};
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLoadingGlobalStateArbiterStressTest, "GCLoading.GlobalStateArbiter.MultiInstanceStress", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLoadingGlobalStateArbiterStressTest::RunTest(const FString& Parameters)
+{
+	using namespace LoadingGlobalStateArbiterTests;
+
+	static constexpr auto NumInstances{ 8 };
+	static constexpr auto NumSteps{ 2000 };
+
+	// The arbiter changes a fake target, so the states of the editor running the test are left alone
+
+	FFakeTarget Target;
+
+	const auto OriginalMaxFPS{ Target.MaxFPS->GetFloat() };
+
+	// State each simulated game instance expects to hold
+
+	struct FInstanceState
+	{
+	public:
+		bool bInputBlocked{ false };
+		bool bSavingPerformance{ false };
+		float Rate{ 0.0f };
+		float AsyncLoadingTimeShare{ 0.0f };
+	};
+
+	FInstanceState Instances[NumInstances];
+
+	FLoadingGlobalStateArbiter Arbiter(Target);
+	FRandomStream Random(0x4C445354);
+
+	for (auto Step{ 0 }; Step < NumSteps; ++Step)
+	{
+		const auto InstanceIndex{ Random.RandRange(0, NumInstances - 1) };
+		auto& Instance{ Instances[InstanceIndex] };
+
+		switch (Random.RandRange(0, 2))
+		{
+		case 0:
+			Instance.bInputBlocked = !Instance.bInputBlocked;
+			Instance.bInputBlocked ? Arbiter.AcquireInputBlock() : Arbiter.ReleaseInputBlock();
+			break;
+
+		case 1:
+			Instance.bSavingPerformance = !Instance.bSavingPerformance;
+			Instance.bSavingPerformance ? Arbiter.AcquireSavingPerformance() : Arbiter.ReleaseSavingPerformance();
+			break;
+
+		default:
+			{
+				// Rates of different instances never tie, so the expected share is unambiguous
+
+				const auto bRelease{ Random.FRand() < 0.3f };
+
+				Instance.Rate = bRelease ? 0.0f : (10.0f + (InstanceIndex * 5.0f) + Random.RandRange(0, 4));
+				Instance.AsyncLoadingTimeShare = bRelease ? 0.0f : Random.FRandRange(0.1f, 0.9f);
+
+				Arbiter.RequestPresentationRate(&Instance, Instance.Rate, Instance.AsyncLoadingTimeShare);
+			}
+			break;
+		}
+
+		// Compare with the state expected from all instances
+
+		auto bExpectedInputBlocked{ false };
+		auto bExpectedSavingPerformance{ false };
+		const FInstanceState* ExpectedRateInstance{ nullptr };
+
+		for (const auto& Other : Instances)
+		{
+			bExpectedInputBlocked |= Other.bInputBlocked;
+			bExpectedSavingPerformance |= Other.bSavingPerformance;
+
+			if ((Other.Rate > 0.0f) && (!ExpectedRateInstance || (Other.Rate < ExpectedRateInstance->Rate)))
+			{
+				ExpectedRateInstance = &Other;
+			}
+		}
+
+		const auto ExpectedRate{ ExpectedRateInstance ? ExpectedRateInstance->Rate : 0.0f };
+		const auto ExpectedShare{ ExpectedRateInstance ? ExpectedRateInstance->AsyncLoadingTimeShare : 0.0f };
+		const auto ExpectedMaxFPS{ (ExpectedRate > 0.0f) ? ExpectedRate : OriginalMaxFPS };
+
+		if ((Arbiter.IsInputBlocked() != bExpectedInputBlocked) ||
+			(Arbiter.IsInputPreProcessorRegistered() != bExpectedInputBlocked) ||
+			(Target.bInputPreProcessorRegistered != bExpectedInputBlocked) ||
+			(Arbiter.IsSavingPerformance() != bExpectedSavingPerformance) ||
+			(Target.bSavingPerformance != bExpectedSavingPerformance) ||
+			(Target.MaxFPS->GetFloat() != ExpectedMaxFPS) ||
+			(Target.NumInvalidChanges > 0) ||
+			(Arbiter.GetAppliedPresentationRate() != ExpectedRate) ||
+			(Arbiter.GetAppliedAsyncLoadingTimeShare() != ExpectedShare))
+		{
+			AddError(FString::Printf(TEXT("Arbiter state diverged at step %d (Rate: %.1f, Expected: %.1f, Share: %.2f, Expected: %.2f)"),
+				Step, Arbiter.GetAppliedPresentationRate(), ExpectedRate, Arbiter.GetAppliedAsyncLoadingTimeShare(), ExpectedShare));
+			break;
+		}
+	}
+
+	// Release everything the instances still hold
+
+	for (auto& Instance : Instances)
+	{
+		if (Instance.bInputBlocked)
+		{
+			Arbiter.ReleaseInputBlock();
+		}
+
+		if (Instance.bSavingPerformance)
+		{
+			Arbiter.ReleaseSavingPerformance();
+		}
+
+		Arbiter.RequestPresentationRate(&Instance, 0.0f, 0.0f);
+	}
+
+	TestFalse(TEXT("Input is no longer blocked"), Arbiter.IsInputBlocked());
+	TestFalse(TEXT("Input preprocessor is unregistered"), Arbiter.IsInputPreProcessorRegistered());
+	TestFalse(TEXT("Performance is no longer saved"), Arbiter.IsSavingPerformance());
+	TestEqual(TEXT("Presentation rate is no longer limited"), Arbiter.GetAppliedPresentationRate(), 0.0f);
+
+	TestFalse(TEXT("Target input preprocessor is unregistered"), Target.bInputPreProcessorRegistered);
+	TestFalse(TEXT("Target performance is restored"), Target.bSavingPerformance);
+	TestEqual(TEXT("t.MaxFPS is restored"), Target.MaxFPS->GetFloat(), OriginalMaxFPS);
+	TestEqual(TEXT("Global states are only changed when they switch"), Target.NumInvalidChanges, 0);
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLoadingGlobalStateArbiterInputBlockBeforeSlateTest, "GCLoading.GlobalStateArbiter.InputBlockBeforeSlate", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLoadingGlobalStateArbiterInputBlockBeforeSlateTest::RunTest(const FString& Parameters)
+{
+	using namespace LoadingGlobalStateArbiterTests;
+
+	FFakeTarget Target;
+	Target.bSlateInitialized = false;
+
+	FLoadingGlobalStateArbiter Arbiter(Target);
+
+	// Input blocked before Slate is initialized waits for it
+
+	Arbiter.AcquireInputBlock();
+
+	TestTrue(TEXT("Input is blocked"), Arbiter.IsInputBlocked());
+	TestFalse(TEXT("Input preprocessor cannot be registered without Slate"), Arbiter.IsInputPreProcessorRegistered());
+	TestTrue(TEXT("Registration is retried while Slate is not initialized"), Arbiter.IsInputPreProcessorRegistrationPending());
+	TestTrue(TEXT("Registration stays pending until Slate is initialized"), Arbiter.UpdatePendingInputPreProcessor());
+
+	// The hold that started before Slate was initialized is registered as soon as it is
+
+	Target.bSlateInitialized = true;
+
+	TestFalse(TEXT("Registration is no longer pending once Slate is initialized"), Arbiter.UpdatePendingInputPreProcessor());
+	TestTrue(TEXT("Input preprocessor is registered during the same hold"), Arbiter.IsInputPreProcessorRegistered());
+	TestTrue(TEXT("Target input preprocessor is registered"), Target.bInputPreProcessorRegistered);
+
+	Arbiter.ReleaseInputBlock();
+
+	TestFalse(TEXT("Input preprocessor is unregistered"), Target.bInputPreProcessorRegistered);
+	TestFalse(TEXT("Pending registration is cancelled by the release"), Arbiter.IsInputPreProcessorRegistrationPending());
+
+	// A hold released before Slate is initialized never registers
+
+	Target.bSlateInitialized = false;
+
+	Arbiter.AcquireInputBlock();
+	Arbiter.ReleaseInputBlock();
+
+	Target.bSlateInitialized = true;
+
+	TestFalse(TEXT("Released hold does not register later"), Arbiter.UpdatePendingInputPreProcessor());
+	TestFalse(TEXT("Input preprocessor stays unregistered"), Target.bInputPreProcessorRegistered);
+	TestEqual(TEXT("Global states are only changed when they switch"), Target.NumInvalidChanges, 0);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,131 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LoadingScreenTestEnvironment.h"
+#include "LoadingScreenSubsystem.h"
+#include "Observer/LoadingObserver_AsyncLoading.h"
+#include "GameplayTag/GCLoadingTags_LoadingType.h"
+
+#include "UObject/UnrealType.h"
+
+
+namespace LoadingObserverAsyncLoadingTests
+{
+	/**
+	 * Overrides a config property of the observer that is not exposed outside of it
+	 */
+	template<typename TPropertyType, typename TValueType>
+	bool SetObserverProperty(ULoadingObserver* Observer, FName PropertyName, const TValueType& Value)
+	{
+		auto* Property{ FindFProperty<TPropertyType>(Observer->GetClass(), PropertyName) };
+
+		if (Property)
+		{
+			Property->SetPropertyValue_InContainer(Observer, Value);
+		}
+
+		return Property != nullptr;
+	}
+
+	/**
+	 * Returns whether the async loading process is in the reasons of the loading type
+	 */
+	bool HasAsyncLoadingProcess(const ULoadingScreenSubsystem* Subsystem)
+	{
+		auto bFound{ false };
+
+		Subsystem->ForEachLoadingReason(TAG_LoadingType_Overlay,
+			[&bFound](FName ProcessName, const FText& Reason)
+			{
+				bFound |= (ProcessName == ULoadingObserver_AsyncLoading::NAME_AsyncLoadingProcess) && !Reason.IsEmpty();
+			});
+
+		return bFound;
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLoadingObserverAsyncLoadingStallTest, "GCLoading.Observer.AsyncLoadingStall", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLoadingObserverAsyncLoadingStallTest::RunTest(const FString& Parameters)
+{
+	using namespace LoadingObserverAsyncLoadingTests;
+
+	static constexpr auto DeltaTime{ 1.0f / 60.0f };
+
+	FLoadingScreenTestEnvironment Environment(
+		[](ULoadingDeveloperSettings& Settings)
+		{
+			Settings.ObserverClassesToEnable.Add(FSoftClassPath(ULoadingObserver_AsyncLoading::StaticClass()));
+		});
+
+	if (!Environment.IsValid(*this))
+	{
+		return false;
+	}
+
+	auto* Subsystem{ Environment.GetSubsystem() };
+	ULoadingObserver* Observer{ nullptr };
+
+	for (const auto& ActiveObserver : Subsystem->GetActiveObservers())
+	{
+		if (ActiveObserver && ActiveObserver->IsA<ULoadingObserver_AsyncLoading>())
+		{
+			Observer = ActiveObserver;
+		}
+	}
+
+	if (!TestNotNull(TEXT("Async loading observer is created from the settings"), Observer))
+	{
+		return false;
+	}
+
+	// Any queue depth (including an empty queue) is deep and stalls immediately
+
+	const auto bOverridden
+	{
+		SetObserverProperty<FIntProperty>(Observer, TEXT("QueueDepthThreshold"), -1) &&
+		SetObserverProperty<FFloatProperty>(Observer, TEXT("StallSecs"), 0.0f)
+	};
+
+	if (!TestTrue(TEXT("Stall properties are overridden"), bOverridden))
+	{
+		return false;
+	}
+
+	// The first evaluation starts the stall and the next one displays the loading screen
+
+	Subsystem->Tick(DeltaTime);
+
+	TestFalse(TEXT("Loading screen is not displayed when the stall starts"), HasAsyncLoadingProcess(Subsystem));
+
+	Subsystem->Tick(DeltaTime);
+
+	TestTrue(TEXT("Async loading process is added with a reason once the stall time has passed"), HasAsyncLoadingProcess(Subsystem));
+	TestFalse(TEXT("Reason of the async loading process is set"), Subsystem->GetLoadingReasonFromName(ULoadingObserver_AsyncLoading::NAME_AsyncLoadingProcess).IsEmpty());
+
+	// The process is removed when the queue is no longer deep
+
+	SetObserverProperty<FIntProperty>(Observer, TEXT("QueueDepthThreshold"), MAX_int32);
+
+	Subsystem->Tick(DeltaTime);
+
+	TestFalse(TEXT("Async loading process is removed when the stall ends"), HasAsyncLoadingProcess(Subsystem));
+
+	// An empty format still displays the loading screen with the default reason
+
+	SetObserverProperty<FIntProperty>(Observer, TEXT("QueueDepthThreshold"), -1);
+	SetObserverProperty<FTextProperty>(Observer, TEXT("LoadingReasonFormat"), FText::GetEmpty());
+
+	Subsystem->Tick(DeltaTime);
+	Subsystem->Tick(DeltaTime);
+
+	TestTrue(TEXT("Async loading process is added with the default reason when the format is empty"), HasAsyncLoadingProcess(Subsystem));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,165 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LoadingScreenTestEnvironment.h"
+#include "LoadingObserver_DispatchTest.h"
+#include "LoadingScreenSubsystem.h"
+#include "GameplayTag/GCLoadingTags_LoadingType.h"
+
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+
+
+namespace LoadingObserverDispatchTests
+{
+	/**
+	 * Results of ticking the subsystem with the dispatch test observers
+	 */
+	struct FDispatchRun
+	{
+	public:
+		bool bValid{ false };
+		double GameThreadMs{ 0.0 };
+		int32 NumEvaluationsOffGameThread{ 0 };
+		TArray<FLoadingObserverDispatchTestResult> AppliedResults;
+		TArray<FString> DisplayedReasons;
+	};
+
+	FDispatchRun RunDispatch(FAutomationTestBase& Test, bool bEvaluateInParallel, int32 NumObservers, int32 NumHashRounds, int32 NumTicks)
+	{
+		FDispatchRun Run;
+
+		FLoadingScreenTestEnvironment Environment(
+			[bEvaluateInParallel, NumObservers](ULoadingDeveloperSettings& Settings)
+			{
+				Settings.bEvaluateObserversInParallel = bEvaluateInParallel;
+
+				for (auto Index{ 0 }; Index < NumObservers; ++Index)
+				{
+					Settings.ObserverClassesToEnable.Add(FSoftClassPath(ULoadingObserver_DispatchTest::StaticClass()));
+				}
+			});
+
+		if (!Environment.IsValid(Test))
+		{
+			return Run;
+		}
+
+		auto* Subsystem{ Environment.GetSubsystem() };
+
+		// The observers are initialized by the subsystem, and are told apart by their seed
+
+		TArray<ULoadingObserver_DispatchTest*> Observers;
+
+		for (const auto& ActiveObserver : Subsystem->GetActiveObservers())
+		{
+			if (auto* Observer{ Cast<ULoadingObserver_DispatchTest>(ActiveObserver) })
+			{
+				Observer->Seed = static_cast<uint32>(Observers.Num());
+				Observer->NumHashRounds = NumHashRounds;
+				Observer->AppliedResults = &Run.AppliedResults;
+
+				Observers.Add(Observer);
+			}
+		}
+
+		if (!Test.TestEqual(TEXT("Dispatch test observers are initialized by the subsystem"), Observers.Num(), NumObservers))
+		{
+			return Run;
+		}
+
+		Run.AppliedResults.Reserve(NumObservers * NumTicks);
+
+		{
+			FScopedLoadingScreenLogSuppression LogSuppression;
+
+			const auto StartCycles{ FPlatformTime::Cycles64() };
+
+			for (auto Tick{ 0 }; Tick < NumTicks; ++Tick)
+			{
+				Subsystem->Tick(1.0f / 60.0f);
+			}
+
+			Run.GameThreadMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) / NumTicks;
+		}
+
+		for (auto* Observer : Observers)
+		{
+			Run.NumEvaluationsOffGameThread += Observer->NumEvaluationsOffGameThread;
+			Observer->AppliedResults = nullptr;
+		}
+
+		Subsystem->ForEachLoadingReason(TAG_LoadingType_Overlay,
+			[&Run](FName ProcessName, const FText& Reason)
+			{
+				Run.DisplayedReasons.Add(FString::Printf(TEXT("%s: %s"), *ProcessName.ToString(), *Reason.ToString()));
+			});
+
+		Run.bValid = true;
+
+		return Run;
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLoadingObserverParallelEvaluationCostTest, "GCLoading.Observer.ParallelEvaluationCost", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FLoadingObserverParallelEvaluationCostTest::RunTest(const FString& Parameters)
+{
+	using namespace LoadingObserverDispatchTests;
+
+	static constexpr auto NumObservers{ 4 };
+	static constexpr auto NumHashRounds{ 20000 };
+	static constexpr auto NumTicks{ 200 };
+
+	const auto Sequential{ RunDispatch(*this, false, NumObservers, NumHashRounds, NumTicks) };
+	const auto Parallel{ RunDispatch(*this, true, NumObservers, NumHashRounds, NumTicks) };
+
+	if (!Sequential.bValid || !Parallel.bValid)
+	{
+		return false;
+	}
+
+	AddInfo(FString::Printf(TEXT("Game thread time per tick of %d thread-safe observers (%d hash rounds each): Sequential %.4f ms, Parallel %.4f ms"),
+		NumObservers, NumHashRounds, Sequential.GameThreadMs, Parallel.GameThreadMs));
+
+	// The parallel dispatch applies the same results in the same order as the sequential one
+
+	TestEqual(TEXT("Every evaluation is applied"), Parallel.AppliedResults.Num(), NumObservers * NumTicks);
+	TestEqual(TEXT("Number of applied results matches the sequential dispatch"), Parallel.AppliedResults.Num(), Sequential.AppliedResults.Num());
+
+	for (auto Index{ 0 }; Index < FMath::Min(Parallel.AppliedResults.Num(), Sequential.AppliedResults.Num()); ++Index)
+	{
+		if (!(Parallel.AppliedResults[Index] == Sequential.AppliedResults[Index]))
+		{
+			AddError(FString::Printf(TEXT("Applied result %d differs from the sequential dispatch (Seed: %u, Hash: %08x, Expected Seed: %u, Expected Hash: %08x)"),
+				Index, Parallel.AppliedResults[Index].Seed, Parallel.AppliedResults[Index].Hash, Sequential.AppliedResults[Index].Seed, Sequential.AppliedResults[Index].Hash));
+			break;
+		}
+	}
+
+	TestTrue(TEXT("Displayed loading reasons match the sequential dispatch"), Parallel.DisplayedReasons == Sequential.DisplayedReasons);
+	TestEqual(TEXT("Sequential dispatch evaluates on the game thread"), Sequential.NumEvaluationsOffGameThread, 0);
+
+	// The evaluation is only shared with the workers when the process uses threading
+
+	const auto NumWorkerThreads{ FApp::ShouldUseThreadingForPerformance() ? FTaskGraphInterface::Get().GetNumWorkerThreads() : 0 };
+
+	if (NumWorkerThreads >= 2)
+	{
+		TestTrue(TEXT("Parallel dispatch evaluates on worker threads"), Parallel.NumEvaluationsOffGameThread > 0);
+		TestTrue(TEXT("Parallel dispatch costs the game thread less than the sequential dispatch"), Parallel.GameThreadMs < Sequential.GameThreadMs);
+	}
+	else
+	{
+		AddInfo(FString::Printf(TEXT("Speedup is not checked with %d worker threads"), NumWorkerThreads));
+	}
+
+	return true;
+}
+
+#endif
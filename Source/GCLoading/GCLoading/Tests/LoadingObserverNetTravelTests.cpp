@@ -0,0 +1,217 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LoadingScreenTestEnvironment.h"
+#include "LoadingScreenSubsystem.h"
+#include "Observer/LoadingObserver_NetTravel.h"
+
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/PendingNetGame.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLoadingObserverNetTravelPhaseTest, "GCLoading.Observer.NetTravelPhases", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLoadingObserverNetTravelPhaseTest::RunTest(const FString& Parameters)
+{
+	static constexpr auto DeltaTime{ 1.0f / 60.0f };
+	static constexpr auto ServerMapName{ TEXT("/Game/Maps/NetTravelTestServerMap") };
+
+	FLoadingScreenTestEnvironment Environment(
+		[](ULoadingDeveloperSettings& Settings)
+		{
+			Settings.ObserverClassesToEnable.Add(FSoftClassPath(ULoadingObserver_NetTravel::StaticClass()));
+		});
+
+	if (!Environment.IsValid(*this))
+	{
+		return false;
+	}
+
+	auto* Subsystem{ Environment.GetSubsystem() };
+	auto* World{ Environment.GetWorld() };
+	auto* Context{ Environment.GetGameInstance()->GetWorldContext() };
+	ULoadingObserver_NetTravel* Observer{ nullptr };
+
+	for (const auto& ActiveObserver : Subsystem->GetActiveObservers())
+	{
+		if (auto* NetTravelObserver{ Cast<ULoadingObserver_NetTravel>(ActiveObserver) })
+		{
+			Observer = NetTravelObserver;
+		}
+	}
+
+	if (!TestNotNull(TEXT("Net travel observer is created from the settings"), Observer) || !TestNotNull(TEXT("World context of the game instance"), Context))
+	{
+		return false;
+	}
+
+	// Aborted travels log a warning by design
+
+	AddExpectedError(TEXT("Net travel aborted"), EAutomationExpectedErrorFlags::Contains, 0);
+
+	Observer->PhaseTimeoutSecs = 0.0f;
+	Observer->bWaitForFirstPawn = true;
+
+	auto HasPhaseProcess
+	{
+		[Subsystem](ELoadingNetTravelPhase Phase)
+		{
+			return !Subsystem->GetLoadingReasonFromName(ULoadingObserver_NetTravel::GetPhaseProcessName(Phase)).IsEmpty();
+		}
+	};
+
+	auto HasAnyPhaseProcess
+	{
+		[&]()
+		{
+			return HasPhaseProcess(ELoadingNetTravelPhase::Connect) || HasPhaseProcess(ELoadingNetTravelPhase::MapLoad) ||
+				HasPhaseProcess(ELoadingNetTravelPhase::Join) || HasPhaseProcess(ELoadingNetTravelPhase::FirstPawn);
+		}
+	};
+
+	auto TestPhase
+	{
+		[&](const TCHAR* What, ELoadingNetTravelPhase ExpectedPhase)
+		{
+			TestEqual(What, Observer->GetCurrentPhase(), ExpectedPhase);
+
+			if (ExpectedPhase == ELoadingNetTravelPhase::None)
+			{
+				TestFalse(FString::Printf(TEXT("%s: no phase process remains"), What), HasAnyPhaseProcess());
+			}
+			else
+			{
+				TestTrue(FString::Printf(TEXT("%s: only the process of the phase is added"), What),
+					HasPhaseProcess(ExpectedPhase) && (Subsystem->GetLoadingReasonsFromTag(Observer->LoadingTypeTag).Num() == 1));
+			}
+		}
+	};
+
+	// A new connection that has not received the welcome message starts the travel
+
+	auto StartConnect
+	{
+		[&]()
+		{
+			Context->PendingNetGame = NewObject<UPendingNetGame>(GetTransientPackage());
+			Subsystem->Tick(DeltaTime);
+		}
+	};
+
+	// The map of the server is loaded and the connection is handed over to the world
+
+	auto LoadServerMap
+	{
+		[&]()
+		{
+			Observer->HandlePreLoadMap(*Context, ServerMapName);
+			Context->PendingNetGame = nullptr;
+			Observer->HandlePostLoadMap(World);
+		}
+	};
+
+	// Connect -> MapLoad -> Join -> FirstPawn -> None
+
+	StartConnect();
+	TestPhase(TEXT("Connecting to the server"), ELoadingNetTravelPhase::Connect);
+
+	Observer->HandlePreLoadMap(*Context, ServerMapName);
+	TestPhase(TEXT("Loading the map of the server"), ELoadingNetTravelPhase::MapLoad);
+
+	Context->PendingNetGame = nullptr;
+	Observer->HandlePostLoadMap(World);
+	TestPhase(TEXT("Joining after the map is loaded"), ELoadingNetTravelPhase::Join);
+
+	Subsystem->Tick(DeltaTime);
+	TestPhase(TEXT("Still joining until the player controller is replicated"), ELoadingNetTravelPhase::Join);
+
+	auto* PlayerController{ World->SpawnActor<APlayerController>() };
+
+	if (!TestNotNull(TEXT("Player controller is spawned"), PlayerController))
+	{
+		return false;
+	}
+
+	Subsystem->Tick(DeltaTime);
+	TestPhase(TEXT("Waiting for the first pawn after joining"), ELoadingNetTravelPhase::FirstPawn);
+
+	auto* Pawn{ World->SpawnActor<APawn>() };
+	PlayerController->SetPawn(Pawn);
+
+	Subsystem->Tick(DeltaTime);
+	TestPhase(TEXT("Travel is complete once the pawn is replicated"), ELoadingNetTravelPhase::None);
+
+	PlayerController->SetPawn(nullptr);
+
+	// Network failure aborts the travel, and the failed connection is not tracked again
+
+	StartConnect();
+	TestPhase(TEXT("Connecting before the network failure"), ELoadingNetTravelPhase::Connect);
+
+	Observer->HandleNetworkFailure(World, nullptr, ENetworkFailure::ConnectionLost, FString());
+	TestPhase(TEXT("Network failure aborts the travel"), ELoadingNetTravelPhase::None);
+
+	Subsystem->Tick(DeltaTime);
+	TestPhase(TEXT("Failed connection does not restart the travel"), ELoadingNetTravelPhase::None);
+
+	// Travel failure before the map is loaded aborts the travel, and is ignored without an owner
+
+	StartConnect();
+	TestPhase(TEXT("Connecting before the travel failure"), ELoadingNetTravelPhase::Connect);
+
+	const auto SavedOwnerGameInstance{ Observer->OwnerGameInstance };
+	Observer->OwnerGameInstance = nullptr;
+
+	Observer->HandleTravelFailure(nullptr, ETravelFailure::PendingNetGameCreateFailure, FString());
+	TestPhase(TEXT("Travel failure without an owner is ignored"), ELoadingNetTravelPhase::Connect);
+
+	Observer->OwnerGameInstance = SavedOwnerGameInstance;
+
+	Observer->HandleTravelFailure(nullptr, ETravelFailure::PendingNetGameCreateFailure, FString());
+	TestPhase(TEXT("Travel failure aborts the travel"), ELoadingNetTravelPhase::None);
+
+	// A phase that never finishes times out
+
+	Observer->PhaseTimeoutSecs = 1.0f;
+
+	StartConnect();
+	TestPhase(TEXT("Connecting before the timeout"), ELoadingNetTravelPhase::Connect);
+
+	Observer->PhaseStartTime -= 2.0;
+
+	Subsystem->Tick(DeltaTime);
+	TestPhase(TEXT("Phase times out"), ELoadingNetTravelPhase::None);
+
+	Observer->PhaseTimeoutSecs = 0.0f;
+
+	// A spectator finishes the travel without a pawn
+
+	StartConnect();
+	LoadServerMap();
+	Subsystem->Tick(DeltaTime);
+	TestPhase(TEXT("Waiting for the first pawn before becoming a spectator"), ELoadingNetTravelPhase::FirstPawn);
+
+	if (!PlayerController->PlayerState)
+	{
+		PlayerController->PlayerState = World->SpawnActor<APlayerState>();
+	}
+
+	PlayerController->PlayerState->SetIsSpectator(true);
+
+	Subsystem->Tick(DeltaTime);
+	TestPhase(TEXT("Spectator does not wait for a pawn"), ELoadingNetTravelPhase::None);
+
+	Context->PendingNetGame = nullptr;
+
+	return true;
+}
+
+#endif
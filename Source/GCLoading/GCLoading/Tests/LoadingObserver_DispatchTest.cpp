@@ -0,0 +1,70 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "LoadingObserver_DispatchTest.h"
+
+#include "GameplayTag/GCLoadingTags_LoadingType.h"
+#include "LoadingScreenSubsystem.h"
+
+#include "Misc/Crc.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LoadingObserver_DispatchTest)
+
+
+ULoadingObserver_DispatchTest::ULoadingObserver_DispatchTest(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+}
+
+
+void ULoadingObserver_DispatchTest::EvaluateThreadSafe(float DeltaTime)
+{
+	NumEvaluations++;
+	NumEvaluationsOffGameThread += IsInGameThread() ? 0 : 1;
+
+	auto Hash{ HashCombine(Seed, static_cast<uint32>(NumEvaluations)) };
+
+	for (auto Round{ 0 }; Round < NumHashRounds; ++Round)
+	{
+		Hash = FCrc::MemCrc32(&Hash, sizeof(Hash), static_cast<uint32>(Round));
+	}
+
+	EvaluatedHash = Hash;
+	EvaluatedDeltaTime = DeltaTime;
+}
+
+void ULoadingObserver_DispatchTest::ApplyEvaluation()
+{
+	if (AppliedResults)
+	{
+		AppliedResults->Add({ Seed, EvaluatedHash, EvaluatedDeltaTime });
+	}
+
+	if (!OwnerSubsystem.IsValid())
+	{
+		return;
+	}
+
+	// Odd hashes display the loading process with the hash as reason, even ones hide it
+
+	const FName ProcessName(TEXT("DispatchTestProcess"), static_cast<int32>(Seed) + 1);
+
+	if (EvaluatedHash & 1)
+	{
+		const auto Reason{ FText::FromString(FString::Printf(TEXT("Dispatch Test %08x"), EvaluatedHash)) };
+
+		if (bProcessAdded)
+		{
+			OwnerSubsystem->SetLoadingProcessReason(ProcessName, Reason);
+		}
+		else
+		{
+			bProcessAdded = OwnerSubsystem->AddLoadingProcess(ProcessName, TAG_LoadingType_Overlay, Reason);
+		}
+	}
+	else if (bProcessAdded)
+	{
+		bProcessAdded = false;
+
+		OwnerSubsystem->RemoveLoadingProcess(ProcessName);
+	}
+}
@@ -0,0 +1,77 @@
+﻿// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Observer/LoadingObserver.h"
+
+#include "LoadingObserver_DispatchTest.generated.h"
+
+
+/**
+ * Result applied by a dispatch test observer
+ */
+struct FLoadingObserverDispatchTestResult
+{
+public:
+	uint32 Seed{ 0 };
+	uint32 Hash{ 0 };
+	float DeltaTime{ 0.0f };
+
+public:
+	bool operator==(const FLoadingObserverDispatchTestResult& Other) const
+	{
+		return (Seed == Other.Seed) && (Hash == Other.Hash) && (DeltaTime == Other.DeltaTime);
+	}
+
+};
+
+
+/**
+ * Thread-safe loading observer with a configurable evaluation cost to verify and measure the parallel dispatch
+ * 
+ * Tip:
+ *	The evaluation hashes the seed with the number of evaluations, and the application toggles a loading process from the hash,
+ *	so the results of the sequential and parallel dispatch can be compared.
+ * 
+ * !!!Note!!!:
+ *	Only for automation tests, so it is hidden from the observer classes of the developer settings.
+ */
+UCLASS(NotBlueprintable, HideDropdown, Transient)
+class ULoadingObserver_DispatchTest : public ULoadingObserver
+{
+	GENERATED_BODY()
+public:
+	ULoadingObserver_DispatchTest(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+public:
+	virtual bool IsEvaluationThreadSafe() const override { return true; }
+
+protected:
+	virtual void EvaluateThreadSafe(float DeltaTime) override;
+	virtual void ApplyEvaluation() override;
+
+
+public:
+	//
+	// Seed of the evaluation and number of hash rounds that each evaluation runs
+	//
+	uint32 Seed{ 0 };
+	int32 NumHashRounds{ 0 };
+
+	//
+	// Results in order of application (not recorded if null)
+	//
+	TArray<FLoadingObserverDispatchTestResult>* AppliedResults{ nullptr };
+
+	//
+	// Number of evaluations that ran off the game thread
+	//
+	int32 NumEvaluationsOffGameThread{ 0 };
+
+protected:
+	int32 NumEvaluations{ 0 };
+	uint32 EvaluatedHash{ 0 };
+	float EvaluatedDeltaTime{ 0.0f };
+	bool bProcessAdded{ false };
+
+};
@@ -0,0 +1,112 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LoadingScreenTestEnvironment.h"
+#include "LoadingScreenSubsystem.h"
+#include "GameplayTag/GCLoadingTags_LoadingType.h"
+
+#include "HAL/PlatformTime.h"
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLoadingProcessBatchThroughputTest, "GCLoading.LoadingProcess.BatchThroughput", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FLoadingProcessBatchThroughputTest::RunTest(const FString& Parameters)
+{
+	static constexpr auto NumProcesses{ 64 };
+	static constexpr auto NumRounds{ 200 };
+
+	FLoadingScreenTestEnvironment Environment;
+
+	if (!Environment.IsValid(*this))
+	{
+		return false;
+	}
+
+	auto* Subsystem{ Environment.GetSubsystem() };
+
+	const FGameplayTag Tags[]{ TAG_LoadingType_Fullscreen, TAG_LoadingType_Overlay };
+	const auto Reason{ FText::FromString(TEXT("Test")) };
+
+	FName ProcessNames[NumProcesses];
+
+	for (auto Index{ 0 }; Index < NumProcesses; ++Index)
+	{
+		ProcessNames[Index] = FName(TEXT("BatchTestProcess"), Index + 1);
+	}
+
+	auto NumVisibilityChanges{ 0 };
+	const auto VisibilityHandle{ Subsystem->OnLoadingScreenVisibilityChanged.AddLambda([&NumVisibilityChanges](bool) { NumVisibilityChanges++; }) };
+
+	// A burst of a level loader: every process is added and removed again, then the frame is ticked outside the measurement
+
+	auto RunBurst
+	{
+		[&]()
+		{
+			for (auto Index{ 0 }; Index < NumProcesses; ++Index)
+			{
+				Subsystem->AddLoadingProcess(ProcessNames[Index], Tags[Index % UE_ARRAY_COUNT(Tags)], Reason);
+			}
+
+			for (const auto& ProcessName : ProcessNames)
+			{
+				Subsystem->RemoveLoadingProcess(ProcessName);
+			}
+		}
+	};
+
+	auto MeasureMs
+	{
+		[&](bool bBatched)
+		{
+			auto TotalCycles{ uint64(0) };
+
+			for (auto Round{ 0 }; Round < NumRounds; ++Round)
+			{
+				const auto StartCycles{ FPlatformTime::Cycles64() };
+
+				if (bBatched)
+				{
+					FScopedLoadingProcessBatch Batch(Subsystem);
+					RunBurst();
+				}
+				else
+				{
+					RunBurst();
+				}
+
+				TotalCycles += FPlatformTime::Cycles64() - StartCycles;
+
+				Subsystem->Tick(0.0f);
+			}
+
+			return FPlatformTime::ToMilliseconds64(TotalCycles) / NumRounds;
+		}
+	};
+
+	double UnbatchedMs{ 0.0 };
+	double BatchedMs{ 0.0 };
+	{
+		FScopedLoadingScreenLogSuppression LogSuppression;
+
+		UnbatchedMs = MeasureMs(false);
+		BatchedMs = MeasureMs(true);
+	}
+
+	Subsystem->OnLoadingScreenVisibilityChanged.Remove(VisibilityHandle);
+
+	AddInfo(FString::Printf(TEXT("Burst of %d adds and %d removes: Per call %.4f ms (%.0f ops/s), Batched %.4f ms (%.0f ops/s)"),
+		NumProcesses, NumProcesses,
+		UnbatchedMs, (NumProcesses * 2) / FMath::Max(UnbatchedMs / 1000.0, UE_DOUBLE_SMALL_NUMBER),
+		BatchedMs, (NumProcesses * 2) / FMath::Max(BatchedMs / 1000.0, UE_DOUBLE_SMALL_NUMBER)));
+
+	TestTrue(TEXT("All loading processes are removed after the bursts"), Subsystem->LoadingScreenInfos.IsEmpty());
+	TestEqual(TEXT("Bursts that end within a frame never change the visibility"), NumVisibilityChanges, 0);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,142 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LoadingScreenTestEnvironment.h"
+#include "LoadingScreenSubsystem.h"
+#include "GameplayTag/GCLoadingTags_LoadingType.h"
+
+#include "HAL/PlatformTime.h"
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLoadingProcessNotificationCostTest, "GCLoading.LoadingProcess.PushVersusPollingCost", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FLoadingProcessNotificationCostTest::RunTest(const FString& Parameters)
+{
+	static constexpr auto NumProcesses{ 3 };
+	static constexpr auto NumFrames{ 10000 };
+	static constexpr auto FramesPerReasonChange{ 30 };
+
+	FLoadingScreenTestEnvironment Environment;
+
+	if (!Environment.IsValid(*this))
+	{
+		return false;
+	}
+
+	auto* Subsystem{ Environment.GetSubsystem() };
+
+	const auto Tag{ TAG_LoadingType_Overlay };
+	const FText Reasons[]{ FText::FromString(TEXT("Loading Assets")), FText::FromString(TEXT("Loading Level")) };
+
+	FName ProcessNames[NumProcesses];
+
+	for (auto Index{ 0 }; Index < NumProcesses; ++Index)
+	{
+		ProcessNames[Index] = FName(TEXT("NotificationTestProcess"), Index + 1);
+		Subsystem->AddLoadingProcess(ProcessNames[Index], Tag, Reasons[0]);
+	}
+
+	// Text a loading widget displays for the reasons of its loading type
+
+	FString PolledText;
+	FString PushedText;
+
+	auto BuildFromPolling
+	{
+		[&]()
+		{
+			const auto CurrentReasons{ Subsystem->GetLoadingReasonsFromTag(Tag) };
+
+			PolledText.Reset();
+
+			for (const auto& Reason : CurrentReasons)
+			{
+				PolledText += Reason.ToString();
+				PolledText += TEXT("\n");
+			}
+		}
+	};
+
+	auto BuildFromView
+	{
+		[&]()
+		{
+			PushedText.Reset();
+
+			Subsystem->ForEachLoadingReason(Tag,
+				[&PushedText](FName ProcessName, const FText& Reason)
+				{
+					PushedText += Reason.ToString();
+					PushedText += TEXT("\n");
+				});
+		}
+	};
+
+	// The reasons change in the same frames in both modes, so only the work of the widget differs
+
+	auto RunFrames
+	{
+		[&](TFunctionRef<void()> OnFrame)
+		{
+			const auto StartCycles{ FPlatformTime::Cycles64() };
+
+			for (auto Frame{ 0 }; Frame < NumFrames; ++Frame)
+			{
+				if ((Frame % FramesPerReasonChange) == 0)
+				{
+					const auto& NewReason{ Reasons[(Frame / FramesPerReasonChange) % UE_ARRAY_COUNT(Reasons)] };
+					Subsystem->SetLoadingProcessReason(ProcessNames[Frame % NumProcesses], NewReason);
+				}
+
+				OnFrame();
+			}
+
+			return FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0 / NumFrames;
+		}
+	};
+
+	double PollingUs{ 0.0 };
+	double PushUs{ 0.0 };
+	auto NumRebuilds{ 0 };
+	{
+		FScopedLoadingScreenLogSuppression LogSuppression;
+
+		PollingUs = RunFrames([&]() { BuildFromPolling(); });
+
+		BuildFromView();
+
+		const auto Handle
+		{
+			Subsystem->OnLoadingProcessChangedForTag(Tag).AddLambda(
+				[&](FGameplayTag ChangedTag, FName ProcessName, ELoadingProcessChangeType ChangeType)
+				{
+					NumRebuilds++;
+					BuildFromView();
+				})
+		};
+
+		PushUs = RunFrames([]() {});
+
+		Subsystem->OnLoadingProcessChangedForTag(Tag).Remove(Handle);
+	}
+
+	BuildFromPolling();
+
+	AddInfo(FString::Printf(TEXT("Widget cost per frame with %d processes: Polling %.3f us, Push %.3f us (%d rebuilds in %d frames)"),
+		NumProcesses, PollingUs, PushUs, NumRebuilds, NumFrames));
+
+	TestEqual(TEXT("Pushed text matches the polled text"), PushedText, PolledText);
+	TestTrue(TEXT("Text is only rebuilt when a reason changes"), (NumRebuilds > 0) && (NumRebuilds <= (NumFrames / FramesPerReasonChange) + 1));
+
+	for (const auto& ProcessName : ProcessNames)
+	{
+		Subsystem->RemoveLoadingProcess(ProcessName);
+	}
+
+	return true;
+}
+
+#endif
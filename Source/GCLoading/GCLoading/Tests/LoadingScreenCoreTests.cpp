@@ -0,0 +1,441 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LoadingScreenCore.h"
+
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+
+namespace LoadingScreenCoreTests
+{
+	static constexpr auto NumTypes{ 4 };
+
+	/**
+	 * Clock that only advances when the test moves it
+	 */
+	class FFakeClock : public ILoadingScreenCoreClock
+	{
+	public:
+		double Time{ 0.0 };
+
+		virtual double GetLoadingTime() const override { return Time; }
+	};
+
+	/**
+	 * Core that exposes the reference counts to the test
+	 */
+	class FTestLoadingScreenCore : public FLoadingScreenCore
+	{
+	public:
+		using FLoadingScreenCore::FLoadingScreenCore;
+
+		int32 GetInputBlockCount() const { return InputBlockCount; }
+		int32 GetSavingPerformanceCount() const { return SavingPerformanceCount; }
+	};
+
+	/**
+	 * Loading of a type as the test requested it, kept independently of the core
+	 */
+	struct FExpectedTypeState
+	{
+	public:
+		FLoadingScreenCoreTypeSettings Settings;
+
+		double StartTime{ 0.0 };
+
+		//
+		// Time when the last process was removed, or negative while loading
+		//
+		double EndTime{ -1.0 };
+
+		bool bShown{ false };
+	};
+
+	/**
+	 * Listener that checks every decision of the core against the requested loading
+	 */
+	class FCheckingListener : public ILoadingScreenCoreListener
+	{
+	public:
+		const FFakeClock* Clock{ nullptr };
+		const FLoadingScreenCore* Core{ nullptr };
+
+		FExpectedTypeState Types[NumTypes];
+
+		bool bInputBlocked{ false };
+		bool bSavingPerformance{ false };
+
+		TArray<FString> Violations;
+
+		virtual void HandleLoadingTypeShown(int32 TypeIndex) override
+		{
+			auto& Type{ Types[TypeIndex] };
+
+			if (Type.bShown)
+			{
+				Violations.Add(FString::Printf(TEXT("Type %d was shown twice"), TypeIndex));
+			}
+
+			if (!Core->IsTypeActive(TypeIndex))
+			{
+				Violations.Add(FString::Printf(TEXT("Type %d was shown without loading"), TypeIndex));
+			}
+
+			// Loading shorter than the show delay must never be displayed
+
+			const auto DelaySecs{ static_cast<double>(Type.Settings.ShowDelaySecs) };
+
+			if ((Clock->Time - Type.StartTime) < DelaySecs)
+			{
+				Violations.Add(FString::Printf(TEXT("Type %d was shown %.3fs after loading started, before its delay of %.3fs"), TypeIndex, Clock->Time - Type.StartTime, DelaySecs));
+			}
+
+			if ((Type.EndTime >= 0.0) && ((Type.EndTime - Type.StartTime) < DelaySecs))
+			{
+				Violations.Add(FString::Printf(TEXT("Type %d was shown for loading of %.3fs, shorter than its delay of %.3fs"), TypeIndex, Type.EndTime - Type.StartTime, DelaySecs));
+			}
+
+			Type.bShown = true;
+		}
+
+		virtual void HandleLoadingTypeHidden(int32 TypeIndex) override
+		{
+			if (!Types[TypeIndex].bShown)
+			{
+				Violations.Add(FString::Printf(TEXT("Type %d was hidden without being shown"), TypeIndex));
+			}
+
+			Types[TypeIndex].bShown = false;
+		}
+
+		virtual void HandleLoadingTypeSuppressed(int32 TypeIndex) override
+		{
+			if (Types[TypeIndex].bShown)
+			{
+				Violations.Add(FString::Printf(TEXT("Type %d was suppressed while shown"), TypeIndex));
+			}
+		}
+
+		virtual void HandleInputBlockChanged(bool bBlocked) override
+		{
+			if (bInputBlocked == bBlocked)
+			{
+				Violations.Add(FString::Printf(TEXT("Input block changed to its current state (%s)"), bBlocked ? TEXT("TRUE") : TEXT("FALSE")));
+			}
+
+			bInputBlocked = bBlocked;
+		}
+
+		virtual void HandleSavingPerformanceChanged(bool bSaving) override
+		{
+			if (bSavingPerformance == bSaving)
+			{
+				Violations.Add(FString::Printf(TEXT("Saving performance changed to its current state (%s)"), bSaving ? TEXT("TRUE") : TEXT("FALSE")));
+			}
+
+			bSavingPerformance = bSaving;
+		}
+	};
+
+	/**
+	 * Checks the state of the core after each step and returns the first violation
+	 */
+	static FString CheckInvariants(const FTestLoadingScreenCore& Core, const FCheckingListener& Listener)
+	{
+		if (!Listener.Violations.IsEmpty())
+		{
+			return Listener.Violations[0];
+		}
+
+		if ((Core.GetInputBlockCount() < 0) || (Core.GetSavingPerformanceCount() < 0))
+		{
+			return FString::Printf(TEXT("Reference count is negative (Input: %d, Performance: %d)"), Core.GetInputBlockCount(), Core.GetSavingPerformanceCount());
+		}
+
+		auto ExpectedInputBlockCount{ 0 };
+		auto ExpectedSavingPerformanceCount{ 0 };
+
+		for (auto TypeIndex{ 0 }; TypeIndex < NumTypes; ++TypeIndex)
+		{
+			const auto& Type{ Listener.Types[TypeIndex] };
+
+			if (Core.GetNumProcesses(TypeIndex) < 0)
+			{
+				return FString::Printf(TEXT("Type %d has %d processes"), TypeIndex, Core.GetNumProcesses(TypeIndex));
+			}
+
+			if (Core.IsTypeShown(TypeIndex) != Type.bShown)
+			{
+				return FString::Printf(TEXT("Shown state of type %d does not match the notifications"), TypeIndex);
+			}
+
+			if (Core.IsTypeShown(TypeIndex) && !Core.IsTypeActive(TypeIndex))
+			{
+				return FString::Printf(TEXT("Type %d is shown but not active"), TypeIndex);
+			}
+
+			if (Type.bShown)
+			{
+				ExpectedInputBlockCount += Type.Settings.bBlockInputs ? 1 : 0;
+				ExpectedSavingPerformanceCount += Type.Settings.bSavingPerformance ? 1 : 0;
+			}
+		}
+
+		if ((Core.GetInputBlockCount() != ExpectedInputBlockCount) || (Core.GetSavingPerformanceCount() != ExpectedSavingPerformanceCount))
+		{
+			return FString::Printf(TEXT("Reference counts do not match the shown types (Input: %d/%d, Performance: %d/%d)"),
+				Core.GetInputBlockCount(), ExpectedInputBlockCount, Core.GetSavingPerformanceCount(), ExpectedSavingPerformanceCount);
+		}
+
+		if ((Core.IsInputBlocked() != Listener.bInputBlocked) || (Core.IsSavingPerformance() != Listener.bSavingPerformance))
+		{
+			return TEXT("Notified input block or saving performance does not match the core");
+		}
+
+		return FString();
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLoadingScreenCoreFuzzTest, "GCLoading.Core.RandomOperations", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLoadingScreenCoreFuzzTest::RunTest(const FString& Parameters)
+{
+	using namespace LoadingScreenCoreTests;
+
+	static constexpr auto NumSteps{ 20000 };
+	static constexpr auto MaxDrainTicks{ 1000 };
+
+	FFakeClock Clock;
+	FCheckingListener Listener;
+	FTestLoadingScreenCore Core(Clock, Listener);
+
+	Listener.Clock = &Clock;
+	Listener.Core = &Core;
+
+	Core.SetNumTypes(NumTypes);
+
+	FRandomStream Random(0x4C53434F);
+
+	// Mirrors the requests of the test into the expected state before handing them to the core
+
+	auto AddProcess
+	{
+		[&](int32 TypeIndex)
+		{
+			auto& Type{ Listener.Types[TypeIndex] };
+
+			FLoadingScreenCoreTypeSettings Settings;
+			Settings.ShowDelaySecs = Random.RandRange(0, 2) * 0.5f;
+			Settings.AdditionalSecs = Random.RandRange(0, 1) * 0.5f;
+			Settings.MinVisibleSecs = Random.RandRange(0, 1) * 0.3f;
+			Settings.bBlockInputs = Random.RandRange(0, 1) == 0;
+			Settings.bSavingPerformance = Random.RandRange(0, 1) == 0;
+
+			// Ongoing loading keeps the settings it started with
+
+			if (!Core.IsTypeActive(TypeIndex))
+			{
+				Type.Settings = Settings;
+				Type.StartTime = Clock.Time;
+			}
+
+			Type.EndTime = -1.0;
+
+			Core.AddProcess(TypeIndex, Settings);
+		}
+	};
+
+	auto RemoveProcess
+	{
+		[&](int32 TypeIndex)
+		{
+			Core.RemoveProcess(TypeIndex);
+
+			if (Core.IsTypeActive(TypeIndex) && (Core.GetNumProcesses(TypeIndex) == 0))
+			{
+				Listener.Types[TypeIndex].EndTime = Clock.Time;
+			}
+		}
+	};
+
+	auto RemoveType
+	{
+		[&](int32 TypeIndex)
+		{
+			if (Core.IsTypeActive(TypeIndex))
+			{
+				Listener.Types[TypeIndex].EndTime = Clock.Time;
+			}
+
+			Core.RemoveType(TypeIndex);
+		}
+	};
+
+	auto RunRandomOperation
+	{
+		[&]()
+		{
+			const auto TypeIndex{ Random.RandRange(0, NumTypes - 1) };
+
+			switch (Random.RandRange(0, 3))
+			{
+			case 0:
+			case 1:
+				AddProcess(TypeIndex);
+				break;
+
+			case 2:
+				RemoveProcess(TypeIndex);
+				break;
+
+			default:
+				RemoveType(TypeIndex);
+				break;
+			}
+		}
+	};
+
+	for (auto Step{ 0 }; Step < NumSteps; ++Step)
+	{
+		switch (Random.RandRange(0, 3))
+		{
+		case 0:
+			RunRandomOperation();
+			break;
+
+		case 1:
+			{
+				// Batches are opened and closed at a single point in time, as the subsystem does within a frame
+
+				Core.BeginBatch();
+
+				for (auto Index{ Random.RandRange(1, 4) }; Index > 0; --Index)
+				{
+					RunRandomOperation();
+				}
+
+				Core.EndBatch();
+			}
+			break;
+
+		default:
+			Clock.Time += Random.FRandRange(0.0f, 0.3f);
+			Core.Update();
+			break;
+		}
+
+		const auto Violation{ CheckInvariants(Core, Listener) };
+
+		if (!Violation.IsEmpty())
+		{
+			AddError(FString::Printf(TEXT("Step %d: %s"), Step, *Violation));
+			return true;
+		}
+	}
+
+	// Finish all loading and let the hold time pass
+
+	for (auto TypeIndex{ 0 }; TypeIndex < NumTypes; ++TypeIndex)
+	{
+		RemoveType(TypeIndex);
+	}
+
+	for (auto Tick{ 0 }; (Tick < MaxDrainTicks) && (Core.HasShownType() || Core.IsInputBlocked() || Core.IsSavingPerformance()); ++Tick)
+	{
+		Clock.Time += 0.1;
+		Core.Update();
+	}
+
+	TestEqual(TEXT("No invariant is violated while draining"), CheckInvariants(Core, Listener), FString());
+	TestFalse(TEXT("No loading type stays shown"), Core.HasShownType());
+	TestEqual(TEXT("Input block count returns to zero"), Core.GetInputBlockCount(), 0);
+	TestEqual(TEXT("Saving performance count returns to zero"), Core.GetSavingPerformanceCount(), 0);
+
+	for (auto TypeIndex{ 0 }; TypeIndex < NumTypes; ++TypeIndex)
+	{
+		TestFalse(FString::Printf(TEXT("Type %d is no longer active"), TypeIndex), Core.IsTypeActive(TypeIndex));
+	}
+
+	// Counters do not leak into the next session
+
+	Core.Reset();
+
+	TestEqual(TEXT("Suppressed shows are cleared by reset"), Core.GetNumSuppressedShows(), 0);
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLoadingScreenCoreUpdateCostTest, "GCLoading.Core.UpdateCost", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FLoadingScreenCoreUpdateCostTest::RunTest(const FString& Parameters)
+{
+	using namespace LoadingScreenCoreTests;
+
+	static constexpr auto NumIterations{ 100000 };
+
+	// Lenient floors that still catch an update or a cycle becoming orders of magnitude slower
+
+	static constexpr auto MinIdleUpdatesPerSec{ 1000000.0 };
+	static constexpr auto MinCyclesPerSec{ 100000.0 };
+
+	FFakeClock Clock;
+	ILoadingScreenCoreListener Listener;
+	FLoadingScreenCore Core(Clock, Listener);
+
+	Core.SetNumTypes(NumTypes);
+
+	FLoadingScreenCoreTypeSettings Settings;
+	Settings.ShowDelaySecs = 0.5f;
+	Settings.bBlockInputs = true;
+	Settings.bSavingPerformance = true;
+
+	// Idle updates are paid every frame, so they are measured separately from the loading cycle
+
+	auto StartCycles{ FPlatformTime::Cycles64() };
+
+	for (auto Iteration{ 0 }; Iteration < NumIterations; ++Iteration)
+	{
+		Clock.Time += 0.016;
+		Core.Update();
+	}
+
+	const auto IdleSecs{ FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles) };
+
+	// Each cycle starts a loading, shows it after the delay and hides it
+
+	StartCycles = FPlatformTime::Cycles64();
+
+	for (auto Iteration{ 0 }; Iteration < NumIterations; ++Iteration)
+	{
+		const auto TypeIndex{ Iteration % NumTypes };
+
+		Core.AddProcess(TypeIndex, Settings);
+		Clock.Time += 1.0;
+		Core.Update();
+
+		Core.RemoveProcess(TypeIndex);
+		Core.Update();
+	}
+
+	const auto CycleSecs{ FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles) };
+
+	const auto IdleUpdatesPerSec{ NumIterations / FMath::Max(IdleSecs, UE_DOUBLE_SMALL_NUMBER) };
+	const auto CyclesPerSec{ NumIterations / FMath::Max(CycleSecs, UE_DOUBLE_SMALL_NUMBER) };
+
+	AddInfo(FString::Printf(TEXT("Loading screen core throughput (Idle updates: %.0f/s, %.3f us each, Show and hide cycles: %.0f/s, %.3f us each)"),
+		IdleUpdatesPerSec, IdleSecs * 1000000.0 / NumIterations, CyclesPerSec, CycleSecs * 1000000.0 / NumIterations));
+
+	TestFalse(TEXT("No loading type stays shown after the cycles"), Core.HasShownType());
+	TestTrue(FString::Printf(TEXT("Idle updates reach %.0f/s"), MinIdleUpdatesPerSec), IdleUpdatesPerSec >= MinIdleUpdatesPerSec);
+	TestTrue(FString::Printf(TEXT("Show and hide cycles reach %.0f/s"), MinCyclesPerSec), CyclesPerSec >= MinCyclesPerSec);
+
+	return true;
+}
+
+#endif
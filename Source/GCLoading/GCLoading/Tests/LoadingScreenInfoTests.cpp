@@ -0,0 +1,230 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LoadingScreenTestEnvironment.h"
+#include "LoadingScreenSubsystem.h"
+#include "GameplayTag/GCLoadingTags_LoadingType.h"
+
+#include "HAL/MemoryBase.h"
+
+#include <atomic>
+
+
+namespace LoadingScreenInfoTests
+{
+	/**
+	 * Allocator that forwards to the original allocator and counts the heap allocations made on the game thread while counting
+	 * 
+	 * !!!Note!!!:
+	 *	Other threads may still hold a pointer to it after it is uninstalled, so it must outlive the test.
+	 */
+	class FCountingMalloc : public FMalloc
+	{
+	public:
+		static FCountingMalloc& Get()
+		{
+			static FCountingMalloc Instance;
+			return Instance;
+		}
+
+	protected:
+		FMalloc* InnerMalloc{ nullptr };
+
+		std::atomic<bool> bCounting{ false };
+
+		int32 NumAllocations{ 0 };
+
+		void CountAllocation()
+		{
+			if (bCounting.load(std::memory_order_relaxed) && IsInGameThread())
+			{
+				NumAllocations++;
+			}
+		}
+
+	public:
+		/**
+		 * Installs the allocator and counts the allocations made on the game thread by Func
+		 */
+		int32 CountAllocations(TFunctionRef<void()> Func)
+		{
+			check(IsInGameThread());
+
+			InnerMalloc = GMalloc;
+			GMalloc = this;
+
+			NumAllocations = 0;
+
+			bCounting = true;
+			Func();
+			bCounting = false;
+
+			GMalloc = InnerMalloc;
+
+			return NumAllocations;
+		}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			InnerMalloc->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return InnerMalloc->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return InnerMalloc->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual void Trim(bool bTrimThreadCaches) override
+		{
+			InnerMalloc->Trim(bTrimThreadCaches);
+		}
+
+		virtual void SetupTLSCachesOnCurrentThread() override
+		{
+			InnerMalloc->SetupTLSCachesOnCurrentThread();
+		}
+
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+		{
+			InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return InnerMalloc->IsInternallyThreadSafe();
+		}
+
+		virtual bool ValidateHeap() override
+		{
+			return InnerMalloc->ValidateHeap();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return InnerMalloc->GetDescriptiveName();
+		}
+	};
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLoadingScreenInfoSteadyStateTest, "GCLoading.LoadingScreenInfo.SteadyStateAllocations", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLoadingScreenInfoSteadyStateTest::RunTest(const FString& Parameters)
+{
+	using namespace LoadingScreenInfoTests;
+
+	static constexpr auto NumWarmUpCycles{ 8 };
+	static constexpr auto NumCycles{ 100 };
+	static constexpr auto NumProcesses{ FLoadingScreenInfo::NumInlineProcesses };
+
+	FLoadingScreenTestEnvironment Environment;
+
+	if (!Environment.IsValid(*this))
+	{
+		return false;
+	}
+
+	auto* Subsystem{ Environment.GetSubsystem() };
+
+	const FGameplayTag Tags[]{ TAG_LoadingType_Fullscreen, TAG_LoadingType_Overlay };
+	const auto Reason{ FText::FromString(TEXT("Test")) };
+
+	FName ProcessNames[UE_ARRAY_COUNT(Tags)][NumProcesses + 1];
+
+	for (auto TagIndex{ 0 }; TagIndex < UE_ARRAY_COUNT(Tags); ++TagIndex)
+	{
+		for (auto Index{ 0 }; Index <= NumProcesses; ++Index)
+		{
+			ProcessNames[TagIndex][Index] = FName(*FString::Printf(TEXT("InfoTestProcess_%d"), TagIndex), Index + 1);
+		}
+	}
+
+	// Each cycle creates the infos through AddLoadingProcessNew, fills them through AddLoadingProcessExistType and empties them again
+
+	auto AddAndRemove
+	{
+		[&](int32 NumProcessesPerTag)
+		{
+			for (auto TagIndex{ 0 }; TagIndex < UE_ARRAY_COUNT(Tags); ++TagIndex)
+			{
+				for (auto Index{ 0 }; Index < NumProcessesPerTag; ++Index)
+				{
+					Subsystem->AddLoadingProcess(ProcessNames[TagIndex][Index], Tags[TagIndex], Reason);
+				}
+			}
+
+			for (auto TagIndex{ 0 }; TagIndex < UE_ARRAY_COUNT(Tags); ++TagIndex)
+			{
+				for (auto Index{ 0 }; Index < NumProcessesPerTag; ++Index)
+				{
+					Subsystem->RemoveLoadingProcess(ProcessNames[TagIndex][Index]);
+				}
+			}
+		}
+	};
+
+	// The finished infos are removed by the tick, which is not part of the measured path
+
+	auto NumAllocations{ 0 };
+	auto NumOverflowAllocations{ 0 };
+	{
+		FScopedLoadingScreenLogSuppression LogSuppression;
+
+		for (auto Cycle{ 0 }; Cycle < NumWarmUpCycles; ++Cycle)
+		{
+			AddAndRemove(NumProcesses);
+			Subsystem->Tick(0.0f);
+		}
+
+		for (auto Cycle{ 0 }; Cycle < NumCycles; ++Cycle)
+		{
+			NumAllocations += FCountingMalloc::Get().CountAllocations([&]() { AddAndRemove(NumProcesses); });
+			Subsystem->Tick(0.0f);
+		}
+
+		// Make sure the count above can fail
+
+		NumOverflowAllocations = FCountingMalloc::Get().CountAllocations([&]() { AddAndRemove(NumProcesses + 1); });
+		Subsystem->Tick(0.0f);
+	}
+
+	TestEqual(TEXT("Adding and removing up to the inline count of processes does not allocate in steady state"), NumAllocations, 0);
+	TestTrue(TEXT("Processes over the inline count are moved to the heap"), NumOverflowAllocations > 0);
+	TestTrue(TEXT("All loading processes are removed"), Subsystem->LoadingScreenInfos.IsEmpty());
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,99 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "LoadingScreenTestEnvironment.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LoadingScreenSubsystem.h"
+#include "GameplayTag/GCLoadingTags_LoadingType.h"
+
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Misc/CommandLine.h"
+
+
+FLoadingScreenTestEnvironment::FLoadingScreenTestEnvironment(TFunctionRef<void(ULoadingDeveloperSettings&)> ConfigureSettings)
+{
+	auto* DevSettings{ GetMutableDefault<ULoadingDeveloperSettings>() };
+
+	SavedLoadingScreenDefinitions = DevSettings->LoadingScreenDefinitions;
+	SavedObserverClassesToEnable = DevSettings->ObserverClassesToEnable;
+	bSavedEvaluateObserversInParallel = DevSettings->bEvaluateObserversInParallel;
+	bSavedEnableLoadingHistory = DevSettings->bEnableLoadingHistory;
+	bSavedDetectLoadingScreenHitches = DevSettings->bDetectLoadingScreenHitches;
+	bSavedTrimMemoryOnFullscreenLoading = DevSettings->bTrimMemoryOnFullscreenLoading;
+	SavedLoadingProcessTimeoutSecs = DevSettings->LoadingProcessTimeoutSecs;
+
+	// Nothing is written to disk and no observer of the project runs unless the test asks for it
+
+	DevSettings->LoadingScreenDefinitions.Reset();
+	DevSettings->LoadingScreenDefinitions.Add(TAG_LoadingType_Fullscreen, MakeTestDefinition());
+	DevSettings->LoadingScreenDefinitions.Add(TAG_LoadingType_Overlay, MakeTestDefinition());
+	DevSettings->ObserverClassesToEnable.Reset();
+	DevSettings->bEnableLoadingHistory = false;
+	DevSettings->bDetectLoadingScreenHitches = false;
+	DevSettings->bTrimMemoryOnFullscreenLoading = false;
+	DevSettings->LoadingProcessTimeoutSecs = 0.0f;
+
+	ConfigureSettings(*DevSettings);
+
+	// The subsystem reads the headless option only while it is initialized
+
+	const FString SavedCommandLine{ FCommandLine::Get() };
+	FCommandLine::Append(TEXT(" -LoadingScreenHeadless"));
+
+	GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->AddToRoot();
+	GameInstance->InitializeStandalone();
+
+	FCommandLine::Set(*SavedCommandLine);
+
+	World = GameInstance->GetWorld();
+	Subsystem = GameInstance->GetSubsystem<ULoadingScreenSubsystem>();
+}
+
+FLoadingScreenTestEnvironment::~FLoadingScreenTestEnvironment()
+{
+	GameInstance->Shutdown();
+
+	if (World)
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	GameInstance->RemoveFromRoot();
+
+	auto* DevSettings{ GetMutableDefault<ULoadingDeveloperSettings>() };
+	DevSettings->LoadingScreenDefinitions = SavedLoadingScreenDefinitions;
+	DevSettings->ObserverClassesToEnable = SavedObserverClassesToEnable;
+	DevSettings->bEvaluateObserversInParallel = bSavedEvaluateObserversInParallel;
+	DevSettings->bEnableLoadingHistory = bSavedEnableLoadingHistory;
+	DevSettings->bDetectLoadingScreenHitches = bSavedDetectLoadingScreenHitches;
+	DevSettings->bTrimMemoryOnFullscreenLoading = bSavedTrimMemoryOnFullscreenLoading;
+	DevSettings->LoadingProcessTimeoutSecs = SavedLoadingProcessTimeoutSecs;
+}
+
+FLoadingScreenDefinition FLoadingScreenTestEnvironment::MakeTestDefinition()
+{
+	FLoadingScreenDefinition Definition;
+	Definition.AdditionalSecs = 0.0f;
+	Definition.bBlockInputs = false;
+	Definition.bSavingPerfomance = false;
+
+	return Definition;
+}
+
+bool FLoadingScreenTestEnvironment::IsValid(FAutomationTestBase& Test) const
+{
+	if (!Subsystem)
+	{
+		Test.AddError(TEXT("Loading screen subsystem was not created for the test game instance"));
+		return false;
+	}
+
+	return true;
+}
+
+#endif
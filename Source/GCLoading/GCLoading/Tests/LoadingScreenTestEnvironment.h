@@ -0,0 +1,95 @@
+﻿// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LoadingDeveloperSettings.h"
+#include "GCLoadingLogs.h"
+
+#include "Templates/Function.h"
+
+class UGameInstance;
+class UWorld;
+class ULoadingScreenSubsystem;
+
+
+/**
+ * Game instance with a headless loading screen subsystem initialized from test settings
+ * 
+ * Tip:
+ *	Both test loading types display without delay and change neither input nor performance, so only the subsystem itself is exercised.
+ *	The developer settings and the command line are restored when the environment is destroyed.
+ * 
+ * !!!Note!!!:
+ *	Only the settings that are saved by this environment may be changed in the callback.
+ */
+class FLoadingScreenTestEnvironment
+{
+public:
+	explicit FLoadingScreenTestEnvironment(TFunctionRef<void(ULoadingDeveloperSettings&)> ConfigureSettings = [](ULoadingDeveloperSettings&) {});
+	~FLoadingScreenTestEnvironment();
+
+	UE_NONCOPYABLE(FLoadingScreenTestEnvironment);
+
+	/**
+	 * Returns the definition used for the test loading types
+	 */
+	static FLoadingScreenDefinition MakeTestDefinition();
+
+protected:
+	UGameInstance* GameInstance{ nullptr };
+	UWorld* World{ nullptr };
+	ULoadingScreenSubsystem* Subsystem{ nullptr };
+
+	//
+	// Developer settings overridden by the environment
+	//
+	TMap<FGameplayTag, FLoadingScreenDefinition> SavedLoadingScreenDefinitions;
+	TArray<FSoftClassPath> SavedObserverClassesToEnable;
+	bool bSavedEvaluateObserversInParallel{ false };
+	bool bSavedEnableLoadingHistory{ false };
+	bool bSavedDetectLoadingScreenHitches{ false };
+	bool bSavedTrimMemoryOnFullscreenLoading{ false };
+	float SavedLoadingProcessTimeoutSecs{ 0.0f };
+
+public:
+	UGameInstance* GetGameInstance() const { return GameInstance; }
+	UWorld* GetWorld() const { return World; }
+	ULoadingScreenSubsystem* GetSubsystem() const { return Subsystem; }
+
+	/**
+	 * Returns whether the subsystem was created, adding an error to the test if not
+	 */
+	bool IsValid(FAutomationTestBase& Test) const;
+
+};
+
+
+/**
+ * Hides the loading screen log below warnings while a measurement is running, so that the log output is not measured
+ */
+struct FScopedLoadingScreenLogSuppression
+{
+public:
+	FScopedLoadingScreenLogSuppression()
+		: SavedVerbosity(LogGameCore_LoadingScreen.GetVerbosity())
+	{
+		LogGameCore_LoadingScreen.SetVerbosity(ELogVerbosity::Warning);
+	}
+
+	~FScopedLoadingScreenLogSuppression()
+	{
+		LogGameCore_LoadingScreen.SetVerbosity(SavedVerbosity);
+	}
+
+	UE_NONCOPYABLE(FScopedLoadingScreenLogSuppression);
+
+private:
+	ELogVerbosity::Type SavedVerbosity;
+
+};
+
+#endif
@@ -0,0 +1,148 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LoadingScreenSubsystem.h"
+
+#include "Engine/TextureRenderTarget2D.h"
+#include "Framework/Application/SlateApplication.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "RenderingThread.h"
+#include "Slate/SRetainerWidget.h"
+#include "Slate/WidgetRenderer.h"
+#include "Widgets/Images/SThrobber.h"
+#include "Widgets/Layout/SBorder.h"
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/SOverlay.h"
+#include "Widgets/Text/STextBlock.h"
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLoadingWidgetRenderModeCostTest, "GCLoading.LoadingWidget.RenderModeCost", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FLoadingWidgetRenderModeCostTest::RunTest(const FString& Parameters)
+{
+	static constexpr auto NumTextLines{ 200 };
+	static constexpr auto NumWarmUpFrames{ 10 };
+	static constexpr auto NumFrames{ 300 };
+	static constexpr auto RetainerRedrawFrameInterval{ 4 };
+
+	if (!FApp::CanEverRender() || !FSlateApplication::IsInitialized())
+	{
+		AddInfo(TEXT("Skipped, since Slate cannot render in this process"));
+		return true;
+	}
+
+	const FVector2D DrawSize{ 1280.0, 720.0 };
+
+	auto* RenderTarget{ FWidgetRenderer::CreateTargetFor(DrawSize, TF_Bilinear, false) };
+	RenderTarget->AddToRoot();
+
+	FWidgetRenderer WidgetRenderer(false, true);
+
+	// Mostly static artwork with a small animated spinner, like a typical loading widget
+
+	auto MakeLoadingWidget
+	{
+		[]()
+		{
+			auto Lines{ SNew(SVerticalBox) };
+
+			for (auto Index{ 0 }; Index < NumTextLines; ++Index)
+			{
+				Lines->AddSlot()
+					.AutoHeight()
+					[
+						SNew(STextBlock).Text(FText::FromString(FString::Printf(TEXT("Loading tip line %d"), Index)))
+					];
+			}
+
+			return SNew(SOverlay)
+				+ SOverlay::Slot()
+				[
+					SNew(SBorder)
+					[
+						Lines
+					]
+				]
+				+ SOverlay::Slot()
+				.HAlign(HAlign_Right)
+				.VAlign(VAlign_Bottom)
+				[
+					SNew(SThrobber)
+				];
+		}
+	};
+
+	// Game thread time of the Slate prepass and paint of one frame
+
+	auto MeasureFrameMs
+	{
+		[&](ELoadingWidgetRenderMode RenderMode)
+		{
+			FLoadingScreenDefinition Def;
+			Def.RenderMode = RenderMode;
+			Def.RetainerRedrawFrameInterval = RetainerRedrawFrameInterval;
+
+			const auto Widget{ ULoadingScreenSubsystem::WrapLoadingWidget(MakeLoadingWidget(), Def) };
+
+			// The frame counter does not advance within the test, so the phase of the retainer is moved as the frames would move it
+
+			auto UpdateRetainerPhase
+			{
+				[&](int32 Frame)
+				{
+					if (RenderMode == ELoadingWidgetRenderMode::Retainer)
+					{
+						const auto PhaseOffset{ ((Frame % RetainerRedrawFrameInterval) == 0) ? 0 : 1 };
+						const auto Phase{ static_cast<int32>((GFrameCounter + PhaseOffset) % RetainerRedrawFrameInterval) };
+
+						StaticCastSharedRef<SRetainerWidget>(Widget)->SetRenderingPhase(Phase, RetainerRedrawFrameInterval);
+					}
+				}
+			};
+
+			for (auto Frame{ 0 }; Frame < NumWarmUpFrames; ++Frame)
+			{
+				UpdateRetainerPhase(Frame);
+				WidgetRenderer.DrawWidget(RenderTarget, Widget, DrawSize, 1.0f / 60.0f);
+			}
+
+			FlushRenderingCommands();
+
+			auto TotalCycles{ uint64(0) };
+
+			for (auto Frame{ 0 }; Frame < NumFrames; ++Frame)
+			{
+				UpdateRetainerPhase(Frame);
+
+				const auto StartCycles{ FPlatformTime::Cycles64() };
+
+				WidgetRenderer.DrawWidget(RenderTarget, Widget, DrawSize, 1.0f / 60.0f);
+
+				TotalCycles += FPlatformTime::Cycles64() - StartCycles;
+			}
+
+			FlushRenderingCommands();
+
+			return FPlatformTime::ToMilliseconds64(TotalCycles) / NumFrames;
+		}
+	};
+
+	const auto DefaultMs{ MeasureFrameMs(ELoadingWidgetRenderMode::Default) };
+	const auto InvalidationMs{ MeasureFrameMs(ELoadingWidgetRenderMode::Invalidation) };
+	const auto RetainerMs{ MeasureFrameMs(ELoadingWidgetRenderMode::Retainer) };
+
+	RenderTarget->RemoveFromRoot();
+
+	AddInfo(FString::Printf(TEXT("Slate game thread cost per frame of a loading widget with %d text lines and a spinner: Default %.4f ms, Invalidation %.4f ms, Retainer (every %d frames) %.4f ms"),
+		NumTextLines, DefaultMs, InvalidationMs, RetainerRedrawFrameInterval, RetainerMs));
+
+	TestTrue(TEXT("Retainer mode does not cost more than painting every frame"), RetainerMs <= DefaultMs);
+
+	return true;
+}
+
+#endif
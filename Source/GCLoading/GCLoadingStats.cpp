@@ -0,0 +1,20 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "GCLoadingStats.h"
+
+DEFINE_STAT(STAT_GCLoading_TickObservers);
+DEFINE_STAT(STAT_GCLoading_EvaluateObserversInParallel);
+DEFINE_STAT(STAT_GCLoading_UpdateLoadingWidgets);
+DEFINE_STAT(STAT_GCLoading_CreateWidget);
+DEFINE_STAT(STAT_GCLoading_RemoveWidget);
+DEFINE_STAT(STAT_GCLoading_ForceSlateTick);
+
+DEFINE_STAT(STAT_GCLoading_ActiveProcesses);
+DEFINE_STAT(STAT_GCLoading_ActiveLoadingTypes);
+
+DEFINE_STAT(STAT_GCLoading_Hitches);
+DEFINE_STAT(STAT_GCLoading_SuppressedShows);
+
+LLM_DEFINE_TAG(GCLoading_Widgets);
+
+CSV_DEFINE_CATEGORY_MODULE(GCLOADING_API, GCLoading, true);
@@ -0,0 +1,26 @@
+﻿// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Stats/Stats.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DECLARE_STATS_GROUP(TEXT("GCLoading"), STATGROUP_GCLoading, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tick Observers"), STAT_GCLoading_TickObservers, STATGROUP_GCLoading, GCLOADING_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Evaluate Observers In Parallel"), STAT_GCLoading_EvaluateObserversInParallel, STATGROUP_GCLoading, GCLOADING_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Loading Widgets"), STAT_GCLoading_UpdateLoadingWidgets, STATGROUP_GCLoading, GCLOADING_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Create Loading Widget"), STAT_GCLoading_CreateWidget, STATGROUP_GCLoading, GCLOADING_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Remove Loading Widget"), STAT_GCLoading_RemoveWidget, STATGROUP_GCLoading, GCLOADING_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Force Slate Tick"), STAT_GCLoading_ForceSlateTick, STATGROUP_GCLoading, GCLOADING_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Active Loading Processes"), STAT_GCLoading_ActiveProcesses, STATGROUP_GCLoading, GCLOADING_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Active Loading Types"), STAT_GCLoading_ActiveLoadingTypes, STATGROUP_GCLoading, GCLOADING_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Loading Screen Hitches"), STAT_GCLoading_Hitches, STATGROUP_GCLoading, GCLOADING_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Suppressed Loading Screens"), STAT_GCLoading_SuppressedShows, STATGROUP_GCLoading, GCLOADING_API);
+
+LLM_DECLARE_TAG_API(GCLoading_Widgets, GCLOADING_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(GCLOADING_API, GCLoading);